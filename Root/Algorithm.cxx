@@ -1,11 +1,19 @@
 // ATLAS
 #include <EventLoop/Job.h>
 #include <xAODRootAccess/Init.h>
+#include <xAODCore/tools/IOStats.h>
+#include <xAODCore/tools/ReadStats.h>
 
 // ROOT
 #include <TSystem.h>
 #include <TFile.h>
 #include <TH1.h>
+#include <TEnv.h>
+#include <TTree.h>
+
+// C++
+#include <set>
+#include <sstream>
 
 // xTRTFrame
 #include <xTRTFrame/Algorithm.h>
@@ -21,6 +29,10 @@ xTRT::Algorithm::~Algorithm() {}
 EL::StatusCode xTRT::Algorithm::setupJob(EL::Job& job) {
   ANA_CHECK_SET_TYPE(EL::StatusCode);
   job.options()->setDouble(EL::Job::optXAODSummaryReport, 0);
+  job.options()->setDouble(EL::Job::optCacheSize, config()->cacheSize()*1024*1024);
+  if ( config()->cacheLearnEntries() > 0 ) {
+    job.options()->setDouble(EL::Job::optCacheLearnEntries, config()->cacheLearnEntries());
+  }
   job.useXAOD();
   xAOD::Init("xTRTFrame").ignore();
   return EL::StatusCode::SUCCESS;
@@ -29,6 +41,10 @@ EL::StatusCode xTRT::Algorithm::setupJob(EL::Job& job) {
 EL::StatusCode xTRT::Algorithm::histInitialize() {
   ANA_CHECK_SET_TYPE(EL::StatusCode);
   TH1::SetDefaultSumw2();
+  // has to be set before the first input file is opened
+  if ( config()->cacheAsyncPrefetch() ) {
+    gEnv->SetValue("TFile.AsyncPrefetching",1);
+  }
   return EL::StatusCode::SUCCESS;
 }
 
@@ -40,16 +56,102 @@ EL::StatusCode xTRT::Algorithm::fileExecute() {
 EL::StatusCode xTRT::Algorithm::changeInput(bool firstFile) {
   ANA_CHECK_SET_TYPE(EL::StatusCode);
   (void)firstFile;
+  // report missing aux variables again for the new file
+  xTRT::clearMissingAux();
+  configureInputCache();
   return EL::StatusCode::SUCCESS;
 }
 
+void xTRT::Algorithm::configureInputCache() {
+  TTree* tree = wk()->tree();
+  if ( tree == nullptr ) return;
+  std::vector<std::string> branches = config()->cacheBranches();
+  branches.insert(branches.end(),m_cacheAutoBranches.begin(),m_cacheAutoBranches.end());
+  // nothing given (yet): the cache learns from the first entries
+  if ( branches.empty() ) return;
+
+  tree->SetCacheSize(static_cast<Long64_t>(config()->cacheSize()*1024*1024));
+  tree->DropBranchFromCache("*",true);
+  std::size_t nCached = 0;
+  for ( const auto& name : branches ) {
+    const bool wildcard = name.find_first_of("*?[") != std::string::npos;
+    if ( not wildcard && tree->GetBranch(name.c_str()) == nullptr ) {
+      ANA_MSG_DEBUG("Input cache: no branch " << name << " in this file");
+      continue;
+    }
+    tree->AddBranchToCache(name.c_str(),true);
+    nCached++;
+  }
+  tree->StopCacheLearningPhase();
+  ANA_MSG_DEBUG("Input cache: " << nCached << " branches, "
+                << config()->cacheSize() << " MB");
+}
+
+void xTRT::Algorithm::learnInputCache() {
+  m_cacheAutoDone = true;
+  const xAOD::ReadStats& stats = xAOD::IOStats::instance().stats();
+  std::set<std::string> read;
+  for ( const auto& container : stats.containers() ) {
+    if ( container.second.readEntries() == 0 ) continue;
+    // interface container and its static aux store
+    read.insert(container.first);
+    read.insert(container.first + "Aux.");
+  }
+  for ( const auto& prefix : stats.branches() ) {
+    for ( const xAOD::BranchStats* branch : prefix.second ) {
+      if ( branch && branch->readEntries() > 0 ) read.insert(branch->GetName());
+    }
+  }
+  m_cacheAutoBranches.assign(read.begin(),read.end());
+  ANA_MSG_INFO("Input cache restricted to " << m_cacheAutoBranches.size()
+               << " branches read in the first " << m_eventCounter << " events");
+  for ( const auto& name : m_cacheAutoBranches ) {
+    ANA_MSG_DEBUG("Input cache branch: " << name);
+  }
+  configureInputCache();
+}
+
 EL::StatusCode xTRT::Algorithm::initialize() {
   ANA_CHECK_SET_TYPE(EL::StatusCode);
   m_event = wk()->xaodEvent();
   m_store = wk()->xaodStore();
   ATH_MSG_INFO("Number of events = " << m_event->getEntries());
 
+  // reset everything counted per job: the same process runs several
+  // jobs (one per event range) under --jobs
   m_eventCounter = 0;
+  m_evtInfoLookupsAvoided = 0;
+  m_trigMatchesAvoided = 0;
+  m_idtsCacheHits = 0;
+  m_idtsToolCalls = 0;
+  m_cacheAutoDone = false;
+  m_cacheAutoBranches.clear();
+  m_cutFlows.clear();
+  m_trackCutFlow = m_electronCutFlow = m_muonCutFlow = nullptr;
+  m_electronEngine.reset();
+  m_muonEngine.reset();
+  xTRT::Timing::reset();
+  xTRT::Timing::enable(config()->timing());
+
+  if ( config()->cutFlow() ) {
+    m_trackCutFlow    = createCutFlow("Tracks",config()->cutFlowCycles());
+    m_electronCutFlow = createCutFlow("Electrons",config()->cutFlowCycles());
+    m_muonCutFlow     = createCutFlow("Muons",config()->cutFlowCycles());
+  }
+  // the cut flows count the cuts in their fixed order, which the
+  // engines would keep changing
+  if ( config()->adaptiveSelection() && config()->cutFlow() ) {
+    ANA_MSG_INFO("Adaptive selection disabled while the cut flows are counted");
+  }
+  else if ( config()->adaptiveSelection() ) {
+    setupSelectionEngines();
+  }
+  m_trackSelection = xTRT::CompiledTrackSelection(config());
+  ANA_MSG_INFO("Track selection: " << m_trackSelection.describe());
+  m_electronKinematics = xTRT::ColumnSelection<xAOD::Electron>();
+  m_electronKinematics.atLeast("pt",xTRT::minimumMeV(config()->elec_pT())).absAtMost("eta",config()->elec_eta());
+  m_muonKinematics = xTRT::ColumnSelection<xAOD::Muon>();
+  m_muonKinematics.atLeast("pt",xTRT::minimumMeV(config()->muon_pT())).absAtMost("eta",config()->muon_eta());
 
   if ( config()->usePRW()  ) ANA_CHECK(enablePRWTool());
   if ( config()->useGRL()  ) ANA_CHECK(enableGRLTool());
@@ -61,6 +163,7 @@ EL::StatusCode xTRT::Algorithm::initialize() {
 
 EL::StatusCode xTRT::Algorithm::execute() {
   ANA_CHECK_SET_TYPE(EL::StatusCode);
+  m_userTimer.reset();
 
   if ( m_eventCounter % config()->eventPrintCounter() == 0 ) {
     ATH_MSG_INFO("Event number = " << m_eventCounter);
@@ -69,19 +172,152 @@ EL::StatusCode xTRT::Algorithm::execute() {
 
   m_event = wk()->xaodEvent();
   m_store = wk()->xaodStore();
-  m_eventInfo = eventInfo();
+  clearEventCache();
+  if ( m_electronEngine ) m_electronEngine->newEvent();
+  if ( m_muonEngine )     m_muonEngine->newEvent();
+  ANA_CHECK(cacheEventInfo());
+
+  if ( xTRT::Timing::enabled() ) {
+    m_userTimer = std::make_unique<xTRT::Timing::StageTimer>(xTRT::Timing::UserExecute);
+  }
+  return EL::StatusCode::SUCCESS;
+}
+
+EL::StatusCode xTRT::Algorithm::cacheEventInfo() {
+  ANA_CHECK_SET_TYPE(EL::StatusCode);
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Retrieve);
+  m_eventInfo = nullptr;
+  if ( evtStore()->retrieve(m_eventInfo,"EventInfo").isFailure() ) {
+    ANA_MSG_ERROR("Cannot retrieve EventInfo for some reason");
+    return EL::StatusCode::FAILURE;
+  }
+
+  m_isMC = m_eventInfo->eventType(xAOD::EventInfo::IS_SIMULATION);
+
+  m_eventWeight = 1.0;
+  if ( m_isMC ) {
+    const auto& weights = m_eventInfo->mcEventWeights();
+    if ( not weights.empty() ) m_eventWeight = weights.at(0);
+  }
+
+  // the PRW and GRL tool calls are left to the first averageMu() and
+  // passGRL() of the event
+  m_averageMuCached = false;
+  m_passGRLCached   = false;
 
   return EL::StatusCode::SUCCESS;
 }
 
+float xTRT::Algorithm::computeAverageMu() {
+  if ( !m_isMC && config()->usePRW() ) {
+    return m_PRWToolHandle->getCorrectedAverageInteractionsPerCrossing(*m_eventInfo,true);
+  }
+  return m_eventInfo->averageInteractionsPerCrossing();
+}
+
+bool xTRT::Algorithm::computePassGRL() const {
+  if ( !m_isMC && config()->useGRL() ) {
+    return m_GRLToolHandle->passRunLB(*m_eventInfo);
+  }
+  return true;
+}
+
+void xTRT::Algorithm::clearEventCache() {
+  m_trackContainer    = nullptr;
+  m_electronContainer = nullptr;
+  m_muonContainer     = nullptr;
+  m_selectedTracks.fill(nullptr);
+  m_selectedElectrons.fill(nullptr);
+  m_selectedMuons.fill(nullptr);
+  m_trackSummariesFilled = false;
+  m_hitColumns = xTRT::HitColumns();
+  m_electronMatchCache.clear();
+  m_muonMatchCache.clear();
+  m_idtsDecisions.clear();
+  m_idtsCache.clear();
+}
+
 EL::StatusCode xTRT::Algorithm::postExecute() {
   ANA_CHECK_SET_TYPE(EL::StatusCode);
+  m_userTimer.reset();
+  flushFillBuffers();
+  if ( not m_cacheAutoDone && config()->cacheAutoEvents() > 0 &&
+       m_eventCounter >= config()->cacheAutoEvents() ) {
+    learnInputCache();
+  }
   return EL::StatusCode::SUCCESS;
 }
 
 EL::StatusCode xTRT::Algorithm::finalize() {
   ANA_CHECK_SET_TYPE(EL::StatusCode);
   ANA_MSG_INFO("Done after " << m_eventCounter << " events.");
+  m_userTimer.reset();
+  if ( xTRT::Timing::enabled() ) {
+    const auto counters = xTRT::Timing::collect();
+    std::ostringstream table;
+    xTRT::Timing::printTable(table,counters,m_eventCounter);
+    ANA_MSG_INFO("Stage timing:");
+    for ( const auto& line : xTRT::stringSplit(table.str(),'\n') ) {
+      ANA_MSG_INFO(line);
+    }
+    const std::string timingFile = jobOutputPath(config()->timingFile());
+    if ( xTRT::Timing::writeJSON(timingFile,counters,m_eventCounter) ) {
+      ANA_MSG_INFO("Stage timing written to " << timingFile);
+    }
+  }
+  flushFillBuffers();
+  if ( not m_fillBuffers.empty() ) {
+    std::size_t n = 0, nRef = 0;
+    double      t = 0, tRef = 0;
+    for ( const auto& buffer : m_fillBuffers ) {
+      n    += buffer->entries();
+      t    += buffer->seconds();
+      nRef += buffer->referenceEntries();
+      tRef += buffer->referenceSeconds();
+    }
+    const double rate    = ( t > 0 ? n/t : 0 );
+    const double rateRef = ( tRef > 0 ? nRef/tRef : 0 );
+    ANA_MSG_INFO("Histogram fill rate, unbuffered TH1::Fill: "
+                 << rateRef << " fills/s (" << nRef << " sampled fills on scratch clones)");
+    ANA_MSG_INFO("Histogram fill rate, buffered: "
+                 << rate << " fills/s (" << n << " fills)"
+                 << ( rateRef > 0 ? ", speedup " + std::to_string(rate/rateRef) : std::string() ));
+    m_fillBuffers.clear();
+  }
+  auto logOrder = [this](const xTRT::SelectionEngineBase& engine) {
+    ANA_MSG_INFO("Selection order (" << engine.name() << ", " << engine.nReorders() << " reorders): "
+                 << engine.describeOrder());
+  };
+  if ( m_electronEngine ) logOrder(*m_electronEngine);
+  if ( m_muonEngine )     logOrder(*m_muonEngine);
+  if ( m_eventCounter > 0 ) {
+    ANA_MSG_INFO("EventInfo store lookups avoided: " << m_evtInfoLookupsAvoided
+                 << " (" << static_cast<double>(m_evtInfoLookupsAvoided)/m_eventCounter
+                 << " per event)");
+    if ( config()->useTrig() ) {
+      ANA_MSG_INFO("Trigger matching calls avoided: " << m_trigMatchesAvoided);
+    }
+    if ( config()->useIDTS() ) {
+      const std::size_t lookups = m_idtsCacheHits + m_idtsToolCalls;
+      ANA_MSG_INFO("InDetTrackSelectionTool decisions: " << lookups << " lookups, "
+                   << m_idtsToolCalls << " tool calls, cache hit rate "
+                   << ( lookups > 0 ? 100.0*m_idtsCacheHits/lookups : 0.0 ) << "%");
+    }
+  }
+  for ( auto& hitStore : m_hitStores ) {
+    if ( not hitStore->close() ) return EL::StatusCode::FAILURE;
+    ANA_MSG_INFO("Hit store: " << hitStore->nTracks() << " tracks, " << hitStore->nHits() << " hits");
+  }
+  m_hitStores.clear();
+  if ( m_strawAccumulator ) {
+    TTree* strawTree = nullptr;
+    SETUP_OUTPUT_TREE(strawTree,"StrawAccumulator");
+    m_strawAccumulator->write(strawTree);
+    ANA_MSG_INFO("Straw accumulator: " << m_strawAccumulator->nStrawsHit() << " straws hit, "
+                 << m_strawAccumulator->nRejected() << " hits with bad straw identifiers, "
+                 << m_strawAccumulator->memoryBytes()/(1024*1024) << " MB");
+    m_strawAccumulator.reset();
+  }
   if ( config()->useIDTS() ) {
     ANA_CHECK(m_idtsTightPrimary->finalize());
     ANA_CHECK(m_idtsLoosePrimary->finalize());
@@ -93,5 +329,30 @@ EL::StatusCode xTRT::Algorithm::finalize() {
 
 EL::StatusCode xTRT::Algorithm::histFinalize() {
   ANA_CHECK_SET_TYPE(EL::StatusCode);
+  if ( not m_cutFlows.empty() ) {
+    std::vector<const xTRT::CutFlow*> flows;
+    for ( const auto& flow : m_cutFlows ) {
+      flows.push_back(flow.get());
+      wk()->addOutput(flow->makeHistogram());
+      ANA_MSG_INFO("Cut flow " << flow->name() << ": " << flow->nAccepted() << " of "
+                   << flow->nObjects() << " objects accepted");
+      for ( const auto& cut : flow->cuts() ) {
+        const double nEval = cut.nEvaluated();
+        ANA_MSG_INFO("  " << cut.name << ": " << cut.nPass << " passed, " << cut.nFail << " failed"
+                     << ( flow->countCycles() && nEval > 0
+                          ? ", " + std::to_string(static_cast<long long>(cut.cycles/nEval)) + " cycles/object"
+                          : std::string() ));
+      }
+      std::string order;
+      for ( const auto& name : flow->suggestedOrder() ) {
+        order += ( order.empty() ? "" : ", " ) + name;
+      }
+      ANA_MSG_INFO("  suggested order: " << order);
+    }
+    const std::string cutFlowFile = jobOutputPath(config()->cutFlowFile());
+    if ( xTRT::writeCutFlowJSON(cutFlowFile,flows) ) {
+      ANA_MSG_INFO("Cut flows written to " << cutFlowFile);
+    }
+  }
   return EL::StatusCode::SUCCESS;
 }
@@ -105,5 +105,15 @@ EL::StatusCode xTRT::Algorithm::enableTriggerTools() {
   ANA_CHECK(m_trigMatchingToolHandle.retrieve());
   ANA_MSG_DEBUG("Retrieved tool: " << m_trigMatchingToolHandle);
 
+  // resolve all configured chain groups once
+  m_electronTrigIds.clear();
+  m_muonTrigIds.clear();
+  for ( const auto& name : config()->electronTriggers() ) m_electronTrigIds.push_back(chainId(name));
+  for ( const auto& name : config()->muonTriggers() )     m_muonTrigIds.push_back(chainId(name));
+  for ( const auto& name : config()->dielectronTriggers() ) chainId(name);
+  for ( const auto& name : config()->dimuonTriggers() )     chainId(name);
+  for ( const auto& name : config()->miscTriggers() )       chainId(name);
+  ANA_MSG_DEBUG("Resolved " << m_chainGroups.size() << " trigger chain groups");
+
   return EL::StatusCode::SUCCESS;
 }
@@ -1,110 +1,332 @@
 #include <xTRTFrame/Algorithm.h>
+#include <xTRTFrame/HitKernels.h>
 
 #include <AsgTools/StatusCode.h>
 #include <xAODCore/AuxContainerBase.h>
 #include <xAODTracking/Vertex.h>
 #include <xAODTracking/TrackParticlexAODHelpers.h>
 
+namespace {
+
+  // truth requirements shared by the electron and muon selections
+  template <class T>
+  bool failsTruth(const T* particle, const bool reqZ, const bool reqJPsi, const bool reqZorJPsi) {
+    if ( not xTRT::Algorithm::truthMatched(particle) ) return true;
+    bool fromZ   = xTRT::Algorithm::isFromZ(particle);
+    if ( reqZ && (not fromZ) ) return true;
+    bool fromJ   = xTRT::Algorithm::isFromJPsi(particle);
+    if ( reqJPsi && (not fromJ) ) return true;
+    bool fromZoJ = (fromZ || fromJ);
+    if ( reqZorJPsi && (not fromZoJ) ) return true;
+    return false;
+  }
+
+  bool failsElectronTrackCuts(const xTRT::TrackSummary* trk, const xTRT::Config* conf) {
+    if ( trk == nullptr ) {
+      XTRT_WARNING("No track from electron! failing selection");
+      return true;
+    }
+    return not xTRT::Algorithm::passTrackSelection(*trk,conf);
+  }
+
+  bool failsElectronRelpT(const xAOD::Electron* electron, const xTRT::TrackSummary* trk,
+                          const xTRT::Config* conf) {
+    if ( trk == nullptr ) {
+      XTRT_WARNING("No track particle from electron! relative pT cut failing");
+      return true;
+    }
+    return trk->pT < (conf->elec_relpT() * electron->pt());
+  }
+
+}
+
 const xAOD::TrackParticleContainer* xTRT::Algorithm::trackContainer() {
-  const xAOD::TrackParticleContainer* trackContainerPtr = nullptr;
-  if ( evtStore()->retrieve(trackContainerPtr,"InDetTrackParticles").isFailure() ) {
+  if ( m_trackContainer ) return m_trackContainer;
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Retrieve);
+  if ( evtStore()->retrieve(m_trackContainer,"InDetTrackParticles").isFailure() ) {
     ANA_MSG_ERROR("InDetTrackParticles unavailable!");
-    return nullptr;
+    m_trackContainer = nullptr;
   }
-  return trackContainerPtr;
+  return m_trackContainer;
 }
 
 const xAOD::ElectronContainer* xTRT::Algorithm::electronContainer() {
-  const xAOD::ElectronContainer* electronContainerPtr = nullptr;
-  if ( evtStore()->retrieve(electronContainerPtr,"Electrons").isFailure() ) {
+  if ( m_electronContainer ) return m_electronContainer;
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Retrieve);
+  if ( evtStore()->retrieve(m_electronContainer,"Electrons").isFailure() ) {
     ANA_MSG_ERROR("Electrons unavailable!");
-    return nullptr;
+    m_electronContainer = nullptr;
   }
-  return electronContainerPtr;
+  return m_electronContainer;
 }
 
 const xAOD::MuonContainer* xTRT::Algorithm::muonContainer() {
-  const xAOD::MuonContainer* muonContainerPtr = nullptr;
-  if ( evtStore()->retrieve(muonContainerPtr,"Muons").isFailure() ) {
+  if ( m_muonContainer ) return m_muonContainer;
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Retrieve);
+  if ( evtStore()->retrieve(m_muonContainer,"Muons").isFailure() ) {
     ANA_MSG_ERROR("Muons unavailable!");
-    return nullptr;
+    m_muonContainer = nullptr;
+  }
+  return m_muonContainer;
+}
+
+const xAOD::TrackParticleContainer* xTRT::Algorithm::selectedTracks(const xTRT::ContainerMode mode) {
+  auto& cached = m_selectedTracks.at(mode);
+  if ( cached ) return cached;
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Selection);
+  auto raw = trackContainer();
+  // counting a cut flow needs the cuts one by one, otherwise the
+  // whole container is decided at once from the summaries
+  if ( m_trackCutFlow ) {
+    auto conf = config();
+    xTRT::selectMask(raw,[this,conf](const xAOD::TrackParticle* track) {
+        return passTrackSelection(trackSummary(track),conf,m_trackCutFlow);
+      },m_trackMask);
+  }
+  else {
+    if ( not m_trackSummariesFilled ) fillTrackSummaries();
+    m_trackSelection.select(m_trackSummaries.data(),m_trackSummaries.size(),m_trackMask);
+  }
+  cached = selectedContainer(raw,m_trackMask,
+                             (mode == xTRT::ContainerMode::VIEW ? "xTRT_GoodTracks" : "xTRT_GoodTracksCopy"),mode);
+  return cached;
+}
+
+const xAOD::ElectronContainer* xTRT::Algorithm::selectedElectrons(const xTRT::ContainerMode mode) {
+  auto& cached = m_selectedElectrons.at(mode);
+  if ( cached ) return cached;
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Selection);
+  auto raw = electronContainer();
+  auto conf = config();
+  auto passes = [this,conf](const xAOD::Electron* electron) {
+    auto trk = getTrack(electron);
+    xTRT::TrackSummary trkSummary;
+    if ( trk != nullptr ) trkSummary = trackSummary(trk);
+    const xTRT::TrackSummary* ts = ( trk != nullptr ) ? &trkSummary : nullptr;
+    if ( m_electronEngine ) return m_electronEngine->pass({electron,ts});
+    return passElectronSelection(electron,ts,conf,m_electronCutFlow);
+  };
+  // without a cut flow to count, the pT and eta columns reject most
+  // electrons before any per object work
+  if ( m_electronCutFlow ) {
+    xTRT::selectMask(raw,passes,m_electronMask);
+  }
+  else {
+    m_electronKinematics.select(raw,m_electronMask);
+    m_electronMask.forEach([this,raw,&passes](const std::size_t i) {
+        if ( not passes((*raw)[i]) ) m_electronMask.reset(i);
+      });
   }
-  return muonContainerPtr;
+  cached = selectedContainer(raw,m_electronMask,
+                             (mode == xTRT::ContainerMode::VIEW ? "xTRT_GoodElectrons" : "xTRT_GoodElectronsCopy"),mode);
+  return cached;
 }
 
-const xAOD::TrackParticleContainer* xTRT::Algorithm::selectedTracks() {
-  return selectedContainer<xAOD::TrackParticleContainer,xAOD::TrackParticle>
-    (trackContainer(),passTrackSelection,"xTRT_GoodTracks");
+const xAOD::MuonContainer* xTRT::Algorithm::selectedMuons(const xTRT::ContainerMode mode) {
+  auto& cached = m_selectedMuons.at(mode);
+  if ( cached ) return cached;
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Selection);
+  auto raw = muonContainer();
+  auto conf = config();
+  auto passes = [this,conf](const xAOD::Muon* muon) {
+    auto trk = getTrack(muon);
+    if ( trk == nullptr ) return passMuonSelection(muon,nullptr,conf,m_muonCutFlow);
+    auto trkSummary = trackSummary(trk);
+    if ( m_muonEngine ) return m_muonEngine->pass({muon,&trkSummary});
+    return passMuonSelection(muon,&trkSummary,conf,m_muonCutFlow);
+  };
+  if ( m_muonCutFlow ) {
+    xTRT::selectMask(raw,passes,m_muonMask);
+  }
+  else {
+    m_muonKinematics.select(raw,m_muonMask);
+    m_muonMask.forEach([this,raw,&passes](const std::size_t i) {
+        if ( not passes((*raw)[i]) ) m_muonMask.reset(i);
+      });
+  }
+  cached = selectedContainer(raw,m_muonMask,
+                             (mode == xTRT::ContainerMode::VIEW ? "xTRT_GoodMuons" : "xTRT_GoodMuonsCopy"),mode);
+  return cached;
 }
 
-const xAOD::ElectronContainer* xTRT::Algorithm::selectedElectrons() {
-  return selectedContainer<xAOD::ElectronContainer,xAOD::Electron>
-    (electronContainer(),passElectronSelection,"xTRT_GoodElectrons");
+xTRT::TrackSummary xTRT::Algorithm::trackSummary(const xAOD::TrackParticle* track) {
+  if ( not m_trackSummariesFilled ) fillTrackSummaries();
+  if ( m_trackContainer != nullptr && track->container() == m_trackContainer &&
+       track->index() < m_trackSummaries.size() ) {
+    return m_trackSummaries[track->index()];
+  }
+  return getTrackSummary(track);
 }
 
-const xAOD::MuonContainer* xTRT::Algorithm::selectedMuons() {
-  return selectedContainer<xAOD::MuonContainer,xAOD::Muon>
-    (muonContainer(),passMuonSelection,"xTRT_GoodMuons");
+void xTRT::Algorithm::fillTrackSummaries() {
+  m_trackSummariesFilled = true;
+  m_trackSummaries.clear();
+  auto tracks = trackContainer();
+  if ( tracks == nullptr || tracks->empty() ) return;
+  const std::size_t ntracks = tracks->size();
+  m_trackSummaries.resize(ntracks);
+
+  // columns the configured Tracks.* cuts read (through the summary
+  // records) must exist: reading them as 0 would silently reject
+  // every track
+  auto conf = config();
+  const bool cutTRT     = conf->track_nTRT() > 0;
+  const bool cutTRTprec = conf->track_nTRTprec() > 0;
+  const bool cutSi      = conf->track_nSi() > 0;
+
+  // each summary value is a contiguous column in the aux store
+  auto fillColumn = [this,tracks,ntracks](const SG::AuxElement::ConstAccessor<unsigned char>& acc,
+                                          const std::string& name,
+                                          uint8_t xTRT::TrackSummary::* field,
+                                          const bool required = false) {
+    auto column = xTRT::auxSpan(acc,tracks,name);
+    if ( not column.available() ) {
+      if ( required ) {
+        XTRT_FATAL(name << " not available, needed by the configured track cuts!");
+      }
+      for ( auto& ts : m_trackSummaries ) ts.*field = 0;
+      return;
+    }
+    for ( std::size_t i = 0; i < ntracks; ++i ) {
+      m_trackSummaries[i].*field = column[i];
+    }
+  };
+  fillColumn(xTRT::Acc::numberOfTRTHits,                 "numberOfTRTHits",                 &xTRT::TrackSummary::nTRTHits,
+             cutTRT || cutTRTprec);
+  fillColumn(xTRT::Acc::numberOfTRTOutliers,             "numberOfTRTOutliers",             &xTRT::TrackSummary::nTRTOutliers,
+             cutTRT);
+  fillColumn(xTRT::Acc::numberOfTRTHighThresholdHits,    "numberOfTRTHighThresholdHits",    &xTRT::TrackSummary::nTRTHTHits);
+  fillColumn(xTRT::Acc::numberOfTRTHighThresholdOutliers,"numberOfTRTHighThresholdOutliers",&xTRT::TrackSummary::nTRTHTOutliers);
+  fillColumn(xTRT::Acc::numberOfPixelHits,               "numberOfPixelHits",               &xTRT::TrackSummary::nPixelHits,
+             cutSi);
+  fillColumn(xTRT::Acc::numberOfPixelHoles,              "numberOfPixelHoles",              &xTRT::TrackSummary::nPixelHoles);
+  fillColumn(xTRT::Acc::numberOfPixelSharedHits,         "numberOfPixelSharedHits",         &xTRT::TrackSummary::nPixelShared);
+  fillColumn(xTRT::Acc::numberOfInnermostPixelLayerHits, "numberOfInnermostPixelLayerHits", &xTRT::TrackSummary::nIBLHits);
+  fillColumn(xTRT::Acc::numberOfSCTHits,                 "numberOfSCTHits",                 &xTRT::TrackSummary::nSCTHits,
+             cutSi);
+  fillColumn(xTRT::Acc::numberOfSCTHoles,                "numberOfSCTHoles",                &xTRT::TrackSummary::nSCTHoles);
+  fillColumn(xTRT::Acc::numberOfSCTSharedHits,           "numberOfSCTSharedHits",           &xTRT::TrackSummary::nSCTShared);
+
+  // pT, eta and p all follow from the stored theta and q/p
+  const float* thetas  = xTRT::Acc::theta.getDataArray(*tracks);
+  const float* qOverPs = xTRT::Acc::qOverP.getDataArray(*tracks);
+  for ( std::size_t i = 0; i < ntracks; ++i ) {
+    auto& ts = m_trackSummaries[i];
+    ts.theta = thetas[i];
+    ts.p     = 1.0/std::fabs(qOverPs[i]);
+    ts.pT    = ts.p*std::sin(ts.theta);
+    ts.eta   = -std::log(std::tan(0.5*ts.theta));
+  }
+}
+
+std::size_t xTRT::Algorithm::chainId(const std::string& trigName) const {
+  auto itr = m_chainIds.find(trigName);
+  if ( itr != m_chainIds.end() ) return itr->second;
+  const std::size_t id = m_chainGroups.size();
+  m_chainGroups.push_back(m_trigDecToolHandle->getChainGroup(trigName));
+  m_chainNames.push_back(trigName);
+  m_chainIds.emplace(trigName,id);
+  return id;
 }
 
 bool xTRT::Algorithm::triggerPassed(const std::string trigName) const {
-  auto chainGroup = m_trigDecToolHandle->getChainGroup(trigName);
-  auto passed = chainGroup->isPassed();
-  return passed;
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Trigger);
+  return m_chainGroups[chainId(trigName)]->isPassed();
 }
 
 bool xTRT::Algorithm::triggersPassed(const std::vector<std::string>& trigNames) const {
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Trigger);
   for ( const auto& name : trigNames ) {
-    auto chainGroup = m_trigDecToolHandle->getChainGroup(name);
-    if ( chainGroup->isPassed() ) return true;
+    if ( m_chainGroups[chainId(name)]->isPassed() ) return true;
   }
   return false;
 }
 
-bool xTRT::Algorithm::singleElectronTrigMatched(const xAOD::Electron* electron) {
-  if ( not config()->useTrig() ) {
-    ANA_MSG_WARNING("Asking for trigger matching without trigger enabled? Ret false");
+bool xTRT::Algorithm::trigMatched(const xAOD::IParticle* particle, const SG::AuxVectorData* rawContainer,
+                                  const std::size_t rawSize, const std::vector<std::size_t>& ids,
+                                  std::vector<int8_t>& cache) {
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Trigger);
+  auto match = [this,particle](const std::size_t id) {
+    return m_trigMatchingToolHandle->match(*particle,m_chainNames[id]);
+  };
+
+  // only objects in the raw container have a stable index to cache by
+  if ( particle->container() != rawContainer ) {
+    for ( const auto id : ids ) {
+      if ( match(id) ) return true;
+    }
     return false;
   }
-  for ( const std::string trigstr : config()->electronTriggers() ) {
-    if ( m_trigMatchingToolHandle->match(*electron,trigstr) ) {
-      return true;
+
+  const std::size_t nids = ids.size();
+  if ( cache.size() != rawSize*nids ) cache.assign(rawSize*nids,-1);
+  int8_t* results = cache.data() + particle->index()*nids;
+  for ( std::size_t i = 0; i < nids; ++i ) {
+    if ( results[i] < 0 ) {
+      results[i] = match(ids[i]) ? 1 : 0;
     }
+    else {
+      m_trigMatchesAvoided++;
+    }
+    if ( results[i] == 1 ) return true;
   }
   return false;
 }
 
-bool xTRT::Algorithm::singleMuonTrigMatched(const xAOD::Muon* muon) {
+bool xTRT::Algorithm::singleElectronTrigMatched(const xAOD::Electron* electron) {
   if ( not config()->useTrig() ) {
     ANA_MSG_WARNING("Asking for trigger matching without trigger enabled? Ret false");
     return false;
   }
-  for ( const std::string trigstr : config()->muonTriggers() ) {
-    if ( m_trigMatchingToolHandle->match(*muon,trigstr) ) {
-      return true;
-    }
-  }
-  return false;
+  // electronContainer() reports a failed retrieval
+  auto electrons = electronContainer();
+  if ( electrons == nullptr ) return false;
+  return trigMatched(electron,electrons,electrons->size(),m_electronTrigIds,m_electronMatchCache);
 }
 
-float xTRT::Algorithm::eventWeight() {
-  const xAOD::EventInfo* evtinfo = eventInfo();
-  if ( evtinfo->eventType(xAOD::EventInfo::IS_SIMULATION) ) {
-    auto weights = evtinfo->mcEventWeights();
-    if ( not weights.empty() ) return weights.at(0);
-    return 1.0;
+bool xTRT::Algorithm::singleMuonTrigMatched(const xAOD::Muon* muon) {
+  if ( not config()->useTrig() ) {
+    ANA_MSG_WARNING("Asking for trigger matching without trigger enabled? Ret false");
+    return false;
   }
-  return 1.0;
+  // muonContainer() reports a failed retrieval
+  auto muons = muonContainer();
+  if ( muons == nullptr ) return false;
+  return trigMatched(muon,muons,muons->size(),m_muonTrigIds,m_muonMatchCache);
 }
 
-float xTRT::Algorithm::averageMu() {
-  const xAOD::EventInfo* evtinfo = eventInfo();
-  if ( !(evtinfo->eventType(xAOD::EventInfo::IS_SIMULATION)) && config()->usePRW() ) {
-    return m_PRWToolHandle->getCorrectedAverageInteractionsPerCrossing(*evtinfo,true);
+bool xTRT::Algorithm::idtsAccept(const xAOD::TrackParticle* trk, const xAOD::Vertex* vtx,
+                                 const xTRT::IDTSCut cut) {
+  asg::AnaToolHandle<InDet::IInDetTrackSelectionTool>* tool = nullptr;
+  switch ( cut ) {
+  case xTRT::IDTSCut::TightPrimary:  tool = &m_idtsTightPrimary;  break;
+  case xTRT::IDTSCut::LoosePrimary:  tool = &m_idtsLoosePrimary;  break;
+  case xTRT::IDTSCut::LooseElectron: tool = &m_idtsLooseElectron; break;
+  case xTRT::IDTSCut::LooseMuon:     tool = &m_idtsLooseMuon;     break;
+  default:
+    ANA_MSG_FATAL("You asked for a track selection cut that we don't have");
+    std::exit(EXIT_FAILURE);
+    break;
   }
-  else {
-    return eventInfo()->averageInteractionsPerCrossing();
+
+  // the vertex is the track's own (trk->vertex()), so the decision
+  // only depends on the track; electrons and muons point into
+  // InDetTrackParticles and share entries with the tracks
+  const uint8_t evaluated = uint8_t(1) << cut;
+  const uint8_t passed    = uint8_t(evaluated << 4);
+  auto tracks = trackContainer();
+  const bool indexed = ( tracks != nullptr && trk->container() == tracks );
+  if ( indexed && m_idtsDecisions.size() != tracks->size() ) m_idtsDecisions.assign(tracks->size(),0);
+  uint8_t& decisions = indexed ? m_idtsDecisions[trk->index()] : m_idtsCache[trk];
+  if ( decisions & evaluated ) {
+    m_idtsCacheHits++;
+    return decisions & passed;
   }
+  m_idtsToolCalls++;
+  xTRT::Timing::StageTimer timer(xTRT::Timing::IDTS);
+  const bool accept = (*tool)->accept(*trk,vtx);
+  decisions |= ( accept ? (evaluated | passed) : evaluated );
+  return accept;
 }
 
 std::size_t xTRT::Algorithm::NPV() const {
@@ -116,13 +338,6 @@ std::size_t xTRT::Algorithm::NPV() const {
   return verts->size();
 }
 
-bool xTRT::Algorithm::passGRL() const {
-  if ( isMC() || !config()->useGRL() ) {
-    return true;
-  }
-  return m_GRLToolHandle->passRunLB(*eventInfo());
-}
-
 float xTRT::Algorithm::deltaz0sinTheta(const xAOD::TrackParticle *track, const xAOD::Vertex* vtx) {
   float delta_z0 = std::fabs(track->z0() + track->vz() - vtx->z());
   float dz0sinth = std::fabs(delta_z0*std::sin(track->theta()));
@@ -137,107 +352,178 @@ double xTRT::Algorithm::d0signif(const xAOD::TrackParticle *track, const xAOD::E
   return d0sig;
 }
 
-bool xTRT::Algorithm::passTrackSelection(const xAOD::TrackParticle* track, const xTRT::Config* conf) {
-  if ( xTRT::Algorithm::nTRT(track) < conf->track_nTRT() ) return false;
-  if ( xTRT::Algorithm::nTRT_PrecTube(track) < conf->track_nTRTprec() ) return false;
-  if ( xTRT::Algorithm::nSilicon(track) < conf->track_nSi() ) return false;
-  if ( track->pt()*toGeV < conf->track_pT() ) return false;
-  if ( std::abs(track->eta()) > conf->track_eta() ) return false;
-  if ( track->p4().P()*toGeV < conf->track_p() ) return false;
-  return true;
+xTRT::TrackSummary xTRT::Algorithm::getTrackSummary(const xAOD::TrackParticle* track) {
+  auto value = [track](const xAOD::SummaryType type) {
+    uint8_t val = 0;
+    if ( not track->summaryValue(val,type) ) return uint8_t(0);
+    return val;
+  };
+  xTRT::TrackSummary ts;
+  ts.nTRTHits       = value(xAOD::numberOfTRTHits);
+  ts.nTRTOutliers   = value(xAOD::numberOfTRTOutliers);
+  ts.nTRTHTHits     = value(xAOD::numberOfTRTHighThresholdHits);
+  ts.nTRTHTOutliers = value(xAOD::numberOfTRTHighThresholdOutliers);
+  ts.nPixelHits     = value(xAOD::numberOfPixelHits);
+  ts.nPixelHoles    = value(xAOD::numberOfPixelHoles);
+  ts.nPixelShared   = value(xAOD::numberOfPixelSharedHits);
+  ts.nIBLHits       = value(xAOD::numberOfInnermostPixelLayerHits);
+  ts.nSCTHits       = value(xAOD::numberOfSCTHits);
+  ts.nSCTHoles      = value(xAOD::numberOfSCTHoles);
+  ts.nSCTShared     = value(xAOD::numberOfSCTSharedHits);
+  ts.theta = track->theta();
+  ts.p     = 1.0/std::fabs(track->qOverP());
+  ts.pT    = track->pt();
+  ts.eta   = track->eta();
+  return ts;
+}
+
+bool xTRT::Algorithm::passTrackSelection(const xAOD::TrackParticle* track, const xTRT::Config* conf,
+                                         xTRT::CutFlow* cutflow) {
+  return passTrackSelection(getTrackSummary(track),conf,cutflow);
+}
+
+bool xTRT::Algorithm::passTrackSelection(const xTRT::TrackSummary& trk, const xTRT::Config* conf,
+                                         xTRT::CutFlow* cutflow) {
+  xTRT::CutFlow::Entry cf(cutflow);
+  if ( cf.fails("nTRT",    [&]{ return trk.nTRT() < conf->track_nTRT(); }) ) return false;
+  if ( cf.fails("nTRTprec",[&]{ return trk.nTRT_PrecTube() < conf->track_nTRTprec(); }) ) return false;
+  if ( cf.fails("nSi",     [&]{ return trk.nSilicon() < conf->track_nSi(); }) ) return false;
+  if ( cf.fails("pT",      [&]{ return trk.pT*toGeV < conf->track_pT(); }) ) return false;
+  if ( cf.fails("eta",     [&]{ return std::abs(trk.eta) > conf->track_eta(); }) ) return false;
+  if ( cf.fails("p",       [&]{ return trk.p*toGeV < conf->track_p(); }) ) return false;
+  return cf.accept();
 }
 
-bool xTRT::Algorithm::passElectronSelection(const xAOD::Electron* electron, const xTRT::Config* conf) {
+bool xTRT::Algorithm::passElectronSelection(const xAOD::Electron* electron, const xTRT::Config* conf,
+                                            xTRT::CutFlow* cutflow) {
   auto trk = xAOD::EgammaHelpers::getOriginalTrackParticle(electron);
+  if ( trk == nullptr ) return passElectronSelection(electron,nullptr,conf,cutflow);
+  auto trkSummary = getTrackSummary(trk);
+  return passElectronSelection(electron,&trkSummary,conf,cutflow);
+}
 
+bool xTRT::Algorithm::passElectronSelection(const xAOD::Electron* electron,
+                                            const xTRT::TrackSummary* trk,
+                                            const xTRT::Config* conf,
+                                            xTRT::CutFlow* cutflow) {
+  xTRT::CutFlow::Entry cf(cutflow);
   if ( conf->elec_truthMatched() ) {
-    if ( not truthMatched(electron) ) return false;
-    bool fromZ   = isFromZ(electron);
-    if ( conf->elec_fromZ() && (not fromZ) ) return false;
-    bool fromJ   = isFromJPsi(electron);
-    if ( conf->elec_fromJPsi() && (not fromJ) ) return false;
-    bool fromZoJ = (fromZ || fromJ);
-    if ( conf->elec_fromZorJPsi() && (not fromZoJ) ) return false;
+    auto truth = [&]{
+      return failsTruth(electron,conf->elec_fromZ(),conf->elec_fromJPsi(),conf->elec_fromZorJPsi());
+    };
+    if ( cf.fails("truth",truth) ) return false;
   }
 
   if ( conf->elec_UTC() ) {
-    if ( trk == nullptr ) {
-      XTRT_WARNING("No track from electron! failing selection");
-      return false;
-    }
-    else {
-      if ( not passTrackSelection(trk,conf) ) return false;
-    }
+    if ( cf.fails("trackCuts",[&]{ return failsElectronTrackCuts(trk,conf); }) ) return false;
   }
 
   if ( conf->elec_relpT() > 0 ) {
-    if ( trk == nullptr ) {
-      XTRT_WARNING("No track particle from electron! relative pT cut failing");
-      return false;
-    }
-    else {
-      if ( trk->pt() < (conf->elec_relpT() * electron->pt()) ) return false;
-    }
+    if ( cf.fails("relpT",[&]{ return failsElectronRelpT(electron,trk,conf); }) ) return false;
   }
 
-  if ( electron->pt()*toGeV < conf->elec_pT() ) return false;
-  if ( electron->p4().P()*toGeV < conf->elec_p() ) return false;
-  if ( std::abs(electron->eta()) > conf->elec_eta() ) return false;
+  if ( cf.fails("pT", [&]{ return electron->pt()*toGeV < conf->elec_pT(); }) ) return false;
+  if ( cf.fails("p",  [&]{ return electron->p4().P()*toGeV < conf->elec_p(); }) ) return false;
+  if ( cf.fails("eta",[&]{ return std::abs(electron->eta()) > conf->elec_eta(); }) ) return false;
 
-  return true;
+  return cf.accept();
 }
 
-bool xTRT::Algorithm::passMuonSelection(const xAOD::Muon* muon, const xTRT::Config* conf) {
-  auto idtl = muon->inDetTrackParticleLink();
-  if ( not idtl.isValid() ) return false;
-  auto trk = *idtl;
+bool xTRT::Algorithm::passMuonSelection(const xAOD::Muon* muon, const xTRT::Config* conf,
+                                        xTRT::CutFlow* cutflow) {
+  auto trk = getTrack(muon);
+  if ( trk == nullptr ) return passMuonSelection(muon,nullptr,conf,cutflow);
+  auto trkSummary = getTrackSummary(trk);
+  return passMuonSelection(muon,&trkSummary,conf,cutflow);
+}
+
+bool xTRT::Algorithm::passMuonSelection(const xAOD::Muon* muon,
+                                        const xTRT::TrackSummary* trk,
+                                        const xTRT::Config* conf,
+                                        xTRT::CutFlow* cutflow) {
+  xTRT::CutFlow::Entry cf(cutflow);
+  // no valid muon->inDetTrackParticleLink()
+  if ( cf.fails("track",[&]{ return trk == nullptr; }) ) return false;
 
   if ( conf->muon_truthMatched() ) {
-    if ( not truthMatched(muon) ) return false;
-    bool fromZ   = isFromZ(muon);
-    if ( conf->muon_fromZ() && (not fromZ) ) return false;
-    bool fromJ   = isFromJPsi(muon);
-    if ( conf->muon_fromJPsi() && (not fromJ) ) return false;
-    bool fromZoJ = (fromZ || fromJ);
-    if ( conf->muon_fromZorJPsi() && (not fromZoJ) ) return false;
+    auto truth = [&]{
+      return failsTruth(muon,conf->muon_fromZ(),conf->muon_fromJPsi(),conf->muon_fromZorJPsi());
+    };
+    if ( cf.fails("truth",truth) ) return false;
   }
 
   if ( conf->muon_UTC() ) {
-    if ( trk == nullptr ) {
-      XTRT_WARNING("No valid muon->inDetTrackParticleLink()! auto failing track selection");
-      return false;
-    }
-    else {
-      if ( not passTrackSelection(trk,conf) ) return false;
-    }
+    if ( cf.fails("trackCuts",[&]{ return not passTrackSelection(*trk,conf); }) ) return false;
   }
 
   if ( conf->muon_relpT() > 0 ) {
-    if ( trk == nullptr ) {
-      XTRT_WARNING("No valid muon->inDetTrackParticleLink()! auto failing rel pT selection");
-      return false;
-    }
-    else {
-      if ( trk->pt() < (conf->muon_relpT() * muon->pt()) ) return false;
-    }
+    if ( cf.fails("relpT",[&]{ return trk->pT < (conf->muon_relpT() * muon->pt()); }) ) return false;
   }
 
-  if ( muon->pt()*toGeV < conf->muon_pT() ) return false;
-  if ( muon->p4().P()*toGeV < conf->muon_p() ) return false;
-  if ( std::abs(muon->eta()) > conf->muon_eta() ) return false;
+  if ( cf.fails("pT", [&]{ return muon->pt()*toGeV < conf->muon_pT(); }) ) return false;
+  if ( cf.fails("p",  [&]{ return muon->p4().P()*toGeV < conf->muon_p(); }) ) return false;
+  if ( cf.fails("eta",[&]{ return std::abs(muon->eta()) > conf->muon_eta(); }) ) return false;
 
-  return true;
+  return cf.accept();
+}
+
+void xTRT::Algorithm::setupSelectionEngines() {
+  // the same cuts as passElectronSelection and passMuonSelection
+  const auto conf = config();
+  const auto learn  = config()->selectionLearnEvents();
+  const auto period = config()->selectionReorderPeriod();
+
+  using ElectronCand = xTRT::Candidate<xAOD::Electron>;
+  m_electronEngine = std::make_unique<xTRT::SelectionEngine<ElectronCand>>("Electrons",learn,period);
+  auto& el = *m_electronEngine;
+  if ( conf->elec_truthMatched() ) {
+    el.addCut("truth",[conf](const ElectronCand& c) {
+        return not failsTruth(c.object,conf->elec_fromZ(),conf->elec_fromJPsi(),conf->elec_fromZorJPsi());
+      });
+  }
+  if ( conf->elec_UTC() ) {
+    el.addCut("trackCuts",[conf](const ElectronCand& c) { return not failsElectronTrackCuts(c.track,conf); });
+  }
+  if ( conf->elec_relpT() > 0 ) {
+    el.addCut("relpT",[conf](const ElectronCand& c) { return not failsElectronRelpT(c.object,c.track,conf); });
+  }
+  el.addCut("pT", [conf](const ElectronCand& c) { return not (c.object->pt()*toGeV < conf->elec_pT()); });
+  el.addCut("p",  [conf](const ElectronCand& c) { return not (c.object->p4().P()*toGeV < conf->elec_p()); });
+  el.addCut("eta",[conf](const ElectronCand& c) { return not (std::abs(c.object->eta()) > conf->elec_eta()); });
+
+  // muons without a track are rejected before the engine, c.track is never null
+  using MuonCand = xTRT::Candidate<xAOD::Muon>;
+  m_muonEngine = std::make_unique<xTRT::SelectionEngine<MuonCand>>("Muons",learn,period);
+  auto& mu = *m_muonEngine;
+  if ( conf->muon_truthMatched() ) {
+    mu.addCut("truth",[conf](const MuonCand& c) {
+        return not failsTruth(c.object,conf->muon_fromZ(),conf->muon_fromJPsi(),conf->muon_fromZorJPsi());
+      });
+  }
+  if ( conf->muon_UTC() ) {
+    mu.addCut("trackCuts",[conf](const MuonCand& c) { return passTrackSelection(*c.track,conf); });
+  }
+  if ( conf->muon_relpT() > 0 ) {
+    mu.addCut("relpT",[conf](const MuonCand& c) {
+        return not (c.track->pT < (conf->muon_relpT() * c.object->pt()));
+      });
+  }
+  mu.addCut("pT", [conf](const MuonCand& c) { return not (c.object->pt()*toGeV < conf->muon_pT()); });
+  mu.addCut("p",  [conf](const MuonCand& c) { return not (c.object->p4().P()*toGeV < conf->muon_p()); });
+  mu.addCut("eta",[conf](const MuonCand& c) { return not (std::abs(c.object->eta()) > conf->muon_eta()); });
 }
 
 xTRT::HitSummary xTRT::Algorithm::getHitSummary(const xAOD::TrackParticle* track,
                                                 const xAOD::TrackStateValidation* msos,
                                                 const xAOD::TrackMeasurementValidation* driftCircle) {
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Hits);
   xTRT::HitSummary hit;
   hit.HTMB        = (get(xTRT::Acc::bitPattern, driftCircle,"bitPattern") & 131072) ? 1 : 0;
   hit.tot         =  get(xTRT::Acc::tot,        driftCircle,"tot");
   hit.gasType     =  get(xTRT::Acc::gasType,    driftCircle,"gasType");
   hit.bec         =  get(xTRT::Acc::bec,        driftCircle,"bec");
   hit.layer       =  get(xTRT::Acc::layer,      driftCircle,"layer");
+  hit.phi_module  =  get(xTRT::Acc::phi_module, driftCircle,"phi_module");
   hit.strawlayer  =  get(xTRT::Acc::strawlayer, driftCircle,"strawlayer");
   hit.strawnumber =  get(xTRT::Acc::strawnumber,driftCircle,"strawnumber");
   hit.drifttime   =  get(xTRT::Acc::drifttime,  driftCircle,"drifttime");
@@ -252,24 +538,94 @@ xTRT::HitSummary xTRT::Algorithm::getHitSummary(const xAOD::TrackParticle* track
   hit.HitR       = get(xTRT::Acc::HitR,      msos,"HitR");
   hit.rTrkWire   = get(xTRT::Acc::rTrkWire,  msos,"rTrkWire");
 
-  int part = 0; // 0: barrel ... 1: ECA ... 2: ECB
-  if ( std::abs(hit.bec) == 2 ) {
-    part = ( hit.layer < 6 ) ? 1 : 2;
-  }
-  if ( hit.bec < 0 ) part = -part;
+  xTRT::trackLengthInStrawScalar(&hit.rTrkWire,&hit.localPhi,&hit.bec,1,
+                                 track->theta(),track->phi(),&hit.L);
+
+  return hit;
+}
+
+void xTRT::Algorithm::bindDriftCircleColumns(const xAOD::TrackMeasurementValidation* dc) {
+  auto& cols = m_hitColumns;
+  cols.driftCircles = dc->container();
+  auto cont = cols.driftCircles;
+  cols.bitPattern   = xTRT::auxSpan(xTRT::Acc::bitPattern, cont,"bitPattern");
+  cols.gasType      = xTRT::auxSpan(xTRT::Acc::gasType,    cont,"gasType");
+  cols.bec          = xTRT::auxSpan(xTRT::Acc::bec,        cont,"bec");
+  cols.layer        = xTRT::auxSpan(xTRT::Acc::layer,      cont,"layer");
+  cols.phi_module   = xTRT::auxSpan(xTRT::Acc::phi_module, cont,"phi_module");
+  cols.strawlayer   = xTRT::auxSpan(xTRT::Acc::strawlayer, cont,"strawlayer");
+  cols.strawnumber  = xTRT::auxSpan(xTRT::Acc::strawnumber,cont,"strawnumber");
+  cols.drifttime    = xTRT::auxSpan(xTRT::Acc::drifttime,  cont,"drifttime");
+  cols.tot          = xTRT::auxSpan(xTRT::Acc::tot,        cont,"tot");
+  cols.T0           = xTRT::auxSpan(xTRT::Acc::T0,         cont,"T0");
+}
 
-  hit.L = 999.0;
-  float trackTheta = track->theta();
-  float trackPhi   = track->phi();
-  float strawPhi   = hit.localPhi;
-  if ( part == 0 ) {
-    hit.L = 2*std::sqrt(4.0-hit.rTrkWire*hit.rTrkWire)*1.0/std::fabs(std::sin(trackTheta));
+void xTRT::Algorithm::bindMsosColumns(const xAOD::TrackStateValidation* msos) {
+  auto& cols = m_hitColumns;
+  cols.msoss      = msos->container();
+  auto cont = cols.msoss;
+  cols.type       = xTRT::auxSpan(xTRT::Acc::type,      cont,"type");
+  cols.localX     = xTRT::auxSpan(xTRT::Acc::localX,    cont,"localX");
+  cols.localY     = xTRT::auxSpan(xTRT::Acc::localY,    cont,"localY");
+  cols.localTheta = xTRT::auxSpan(xTRT::Acc::localTheta,cont,"localTheta");
+  cols.localPhi   = xTRT::auxSpan(xTRT::Acc::localPhi,  cont,"localPhi");
+  cols.HitZ       = xTRT::auxSpan(xTRT::Acc::HitZ,      cont,"HitZ");
+  cols.HitR       = xTRT::auxSpan(xTRT::Acc::HitR,      cont,"HitR");
+  cols.rTrkWire   = xTRT::auxSpan(xTRT::Acc::rTrkWire,  cont,"rTrkWire");
+}
+
+std::size_t xTRT::Algorithm::fillHitBlock(const xAOD::TrackParticle* track, xTRT::HitBlock& block) {
+  xTRT::Timing::StageTimer timer(xTRT::Timing::Hits);
+  block.clear();
+  if ( not xTRT::Acc::msosLink.isAvailable(*track) ) {
+    if ( xTRT::firstMissingAux("msosLink") ) {
+      ANA_MSG_WARNING("AuxElement: msosLink not available, no hits for tracks");
+    }
+    return 0;
   }
-  else {
-    hit.L = 2*std::sqrt(4.0-hit.rTrkWire*hit.rTrkWire)*1.0/
-      std::sqrt(1.0-std::sin(trackTheta)*std::sin(trackTheta)*
-                std::cos(trackPhi-strawPhi)*std::cos(trackPhi-strawPhi));
+  const auto& msosLinks = xTRT::Acc::msosLink(*track);
+  block.reserve(msosLinks.size());
+
+  const auto& cols = m_hitColumns;
+  for ( const auto& msosLink : msosLinks ) {
+    if ( not msosLink.isValid() ) continue;
+    const xAOD::TrackStateValidation* msos = *msosLink;
+    if ( msos->detType() != 3 ) continue; // TRT only
+    if ( not msos->trackMeasurementValidationLink().isValid() ) continue;
+    const xAOD::TrackMeasurementValidation* driftCircle = *(msos->trackMeasurementValidationLink());
+    if ( driftCircle == nullptr ) continue;
+
+    if ( msos->container()        != cols.msoss        ) bindMsosColumns(msos);
+    if ( driftCircle->container() != cols.driftCircles ) bindDriftCircleColumns(driftCircle);
+    const std::size_t im = msos->index();
+    const std::size_t id = driftCircle->index();
+
+    block.HTMB.push_back((cols.bitPattern.value(id) & 131072) ? 1 : 0);
+    block.gasType.push_back(cols.gasType.value(id));
+    block.bec.push_back(cols.bec.value(id));
+    block.layer.push_back(cols.layer.value(id));
+    block.phi_module.push_back(cols.phi_module.value(id));
+    block.strawlayer.push_back(cols.strawlayer.value(id));
+    block.strawnumber.push_back(cols.strawnumber.value(id));
+    block.drifttime.push_back(cols.drifttime.value(id));
+    block.tot.push_back(cols.tot.value(id));
+    block.T0.push_back(cols.T0.value(id));
+
+    block.type.push_back(cols.type.value(im));
+    block.localX.push_back(cols.localX.value(im));
+    block.localY.push_back(cols.localY.value(im));
+    block.localTheta.push_back(cols.localTheta.value(im));
+    block.localPhi.push_back(cols.localPhi.value(im));
+    block.HitZ.push_back(cols.HitZ.value(im));
+    block.HitR.push_back(cols.HitR.value(im));
+    block.rTrkWire.push_back(cols.rTrkWire.value(im));
   }
 
-  return hit;
+  // track length in straw, same definition as in getHitSummary
+  const std::size_t nhits = block.size();
+  block.L.resize(nhits);
+  xTRT::trackLengthInStraw(block.rTrkWire.data(),block.localPhi.data(),block.bec.data(),
+                           nhits,track->theta(),track->phi(),block.L.data());
+
+  return nhits;
 }
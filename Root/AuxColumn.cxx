@@ -0,0 +1,18 @@
+#include <xTRTFrame/AuxColumn.h>
+
+#include <set>
+
+namespace {
+  std::set<std::string>& missingAuxRecord() {
+    static std::set<std::string> record;
+    return record;
+  }
+}
+
+bool xTRT::firstMissingAux(const std::string& name) {
+  return missingAuxRecord().insert(name).second;
+}
+
+void xTRT::clearMissingAux() {
+  missingAuxRecord().clear();
+}
@@ -0,0 +1,15 @@
+#include <xTRTFrame/BatchSelection.h>
+#include <xTRTFrame/Utils.h>
+
+#include <cmath>
+#include <limits>
+
+float xTRT::minimumMeV(const float minGeV) {
+  float t = static_cast<float>(minGeV/toGeV);
+  const float lowest  = -std::numeric_limits<float>::infinity();
+  const float highest =  std::numeric_limits<float>::infinity();
+  // the float division can land one or two ulps off either way
+  while ( std::nextafter(t,lowest)*toGeV >= minGeV ) t = std::nextafter(t,lowest);
+  while ( t*toGeV < minGeV ) t = std::nextafter(t,highest);
+  return t;
+}
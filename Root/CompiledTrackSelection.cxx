@@ -0,0 +1,55 @@
+#include <xTRTFrame/CompiledTrackSelection.h>
+#include <xTRTFrame/BatchSelection.h>
+#include <xTRTFrame/Config.h>
+
+#include <cmath>
+#include <sstream>
+
+xTRT::CompiledTrackSelection::CompiledTrackSelection(const xTRT::Config* conf) {
+  if ( conf->track_nTRT() > 0 ) {
+    m_minNTRT = conf->track_nTRT();
+    m_nCuts++;
+  }
+  if ( conf->track_nTRTprec() > 0 ) {
+    m_minNTRTprec = conf->track_nTRTprec();
+    m_nCuts++;
+  }
+  if ( conf->track_nSi() > 0 ) {
+    m_minNSi = conf->track_nSi();
+    m_nCuts++;
+  }
+  // a NaN minimum never rejects; one <= 0 is kept so that the
+  // decision stays exact, but it is not counted as a cut
+  if ( not std::isnan(conf->track_pT()) ) {
+    m_minPT = xTRT::minimumMeV(conf->track_pT());
+    if ( conf->track_pT() > 0 ) m_nCuts++;
+  }
+  if ( not std::isnan(conf->track_eta()) ) {
+    m_maxAbsEta = conf->track_eta();
+    m_nCuts++;
+  }
+  if ( not std::isnan(conf->track_p()) ) {
+    m_minP = xTRT::minimumMeV(conf->track_p());
+    if ( conf->track_p() > 0 ) m_nCuts++;
+  }
+}
+
+void xTRT::CompiledTrackSelection::select(const xTRT::TrackSummary* tracks, const std::size_t n,
+                                          xTRT::BitMask& mask) const {
+  mask.resize(n);
+  for ( std::size_t i = 0; i < n; ++i ) {
+    mask.set(i,pass(tracks[i]));
+  }
+}
+
+std::string xTRT::CompiledTrackSelection::describe() const {
+  std::ostringstream out;
+  out << m_nCuts << " cuts:";
+  if ( m_minNTRT > 0 )     out << " nTRT >= " << m_minNTRT;
+  if ( m_minNTRTprec > 0 ) out << " nTRTprec >= " << m_minNTRTprec;
+  if ( m_minNSi > 0 )      out << " nSi >= " << m_minNSi;
+  if ( m_minPT > 0 )               out << " pT >= " << m_minPT << " MeV";
+  if ( std::isfinite(m_maxAbsEta) ) out << " |eta| <= " << m_maxAbsEta;
+  if ( m_minP > 0 )                out << " p >= " << m_minP << " MeV";
+  return out.str();
+}
@@ -9,6 +9,9 @@ xTRT::Config::~Config() {}
 
 bool xTRT::Config::parse(const std::string fileName, bool print_conf, bool mcMode) {
   m_rootEnv = std::make_unique<TEnv>(fileName.c_str());
+  for ( const auto& ov : m_overrides ) {
+    m_rootEnv->SetValue(ov.first.c_str(),ov.second.c_str());
+  }
 
   m_mcMode  = mcMode;
   m_useGRL  = m_rootEnv->GetValue("GRL",false);
@@ -52,6 +55,29 @@ bool xTRT::Config::parse(const std::string fileName, bool print_conf, bool mcMod
 
   m_eventPrintCounter = m_rootEnv->GetValue("EventPrintCounter",1000);
 
+  m_cacheSize          = m_rootEnv->GetValue("Cache.Size",10.0);
+  m_cacheLearnEntries  = m_rootEnv->GetValue("Cache.LearnEntries",0);
+  m_cacheAsyncPrefetch = m_rootEnv->GetValue("Cache.AsyncPrefetch",false);
+  m_cacheAutoEvents    = m_rootEnv->GetValue("Cache.AutoEvents",0);
+  m_cacheBranches.clear();
+  std::string cachebranches = m_rootEnv->GetValue("Cache.Branches","none");
+  if ( cachebranches != "none" ) {
+    for ( const auto& b : xTRT::stringSplit(cachebranches,',') ) {
+      if ( not b.empty() ) m_cacheBranches.push_back(b);
+    }
+  }
+
+  m_timing     = m_rootEnv->GetValue("Timing",false);
+  m_timingFile = m_rootEnv->GetValue("Timing.JSON","timing.json");
+
+  m_cutFlow       = m_rootEnv->GetValue("CutFlow",false);
+  m_cutFlowCycles = m_rootEnv->GetValue("CutFlow.Cycles",false);
+  m_cutFlowFile   = m_rootEnv->GetValue("CutFlow.JSON","cutflow.json");
+
+  m_adaptiveSelection      = m_rootEnv->GetValue("Selection.Adaptive",false);
+  m_selectionLearnEvents   = m_rootEnv->GetValue("Selection.LearnEvents",100);
+  m_selectionReorderPeriod = m_rootEnv->GetValue("Selection.ReorderPeriod",1000);
+
   cut_track_p        = m_rootEnv->GetValue("Tracks.p",0.0);
   cut_track_pT       = m_rootEnv->GetValue("Tracks.pT",0.0);
   cut_track_eta      = m_rootEnv->GetValue("Tracks.eta",2.0);
@@ -87,6 +113,10 @@ bool xTRT::Config::parse(const std::string fileName, bool print_conf, bool mcMod
   return true;
 }
 
+void xTRT::Config::setOverride(const std::string& name, const std::string& value) {
+  m_overrides[name] = value;
+}
+
 void xTRT::Config::printConf() const {
   std::cout << "======== xTRT Config ========" << std::endl;
 
@@ -117,6 +147,25 @@ void xTRT::Config::printConf() const {
 
   std::cout << "Event print counter: " << m_eventPrintCounter << std::endl;
 
+  std::cout << "Cache size [MB]: " << m_cacheSize << std::endl;
+  std::cout << "Cache learn entries: " << m_cacheLearnEntries << std::endl;
+  std::cout << "Cache async prefetch: " << m_cacheAsyncPrefetch << std::endl;
+  for ( auto const& cb : m_cacheBranches ) {
+    std::cout << "Cache branch: " << cb << std::endl;
+  }
+  std::cout << "Cache auto events: " << m_cacheAutoEvents << std::endl;
+  std::cout << "Timing: " << m_timing << std::endl;
+  std::cout << "Timing JSON: " << m_timingFile << std::endl;
+  std::cout << "CutFlow: " << m_cutFlow << std::endl;
+  std::cout << "CutFlow cycles: " << m_cutFlowCycles << std::endl;
+  std::cout << "CutFlow JSON: " << m_cutFlowFile << std::endl;
+  std::cout << "Adaptive selection: " << m_adaptiveSelection << std::endl;
+  std::cout << "Selection learn events: " << m_selectionLearnEvents << std::endl;
+  std::cout << "Selection reorder period: " << m_selectionReorderPeriod << std::endl;
+  for ( auto const& ov : m_overrides ) {
+    std::cout << "Override: " << ov.first << " = " << ov.second << std::endl;
+  }
+
   std::cout << "Track p cut: " << cut_track_p << std::endl;
   std::cout << "Track pT cut: " << cut_track_pT << std::endl;
   std::cout << "Track eta cut: " << cut_track_eta << std::endl;
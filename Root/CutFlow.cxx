@@ -0,0 +1,151 @@
+#include <xTRTFrame/CutFlow.h>
+#include <xTRTFrame/Utils.h>
+#include <xTRTFrame/Externals/json.hpp>
+
+#include <TH1D.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <memory>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+xTRT::CutFlow::CutFlow(const std::string& name, const bool countCycles) :
+  m_name(name), m_countCycles(countCycles) {}
+
+uint64_t xTRT::CutFlow::ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>
+    (std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+std::size_t xTRT::CutFlow::index(const char* name, const std::size_t hint) {
+  // cuts are almost always evaluated in registration order
+  if ( hint < m_cuts.size() && m_cuts[hint].name == name ) return hint;
+  for ( std::size_t i = 0; i < m_cuts.size(); ++i ) {
+    if ( m_cuts[i].name == name ) return i;
+  }
+  m_cuts.emplace_back();
+  m_cuts.back().name = name;
+  return m_cuts.size() - 1;
+}
+
+void xTRT::CutFlow::add(const std::vector<Cut>& cuts, const uint64_t nObjects, const uint64_t nAccepted) {
+  m_nObjects  += nObjects;
+  m_nAccepted += nAccepted;
+  for ( std::size_t i = 0; i < cuts.size(); ++i ) {
+    auto& cut = m_cuts[index(cuts[i].name.c_str(),i)];
+    cut.nPass  += cuts[i].nPass;
+    cut.nFail  += cuts[i].nFail;
+    cut.cycles += cuts[i].cycles;
+  }
+}
+
+std::vector<std::string> xTRT::CutFlow::suggestedOrder() const {
+  // cost per rejected object; without cycle counts every cut costs the same
+  auto score = [this](const Cut& cut) {
+    if ( cut.nFail == 0 ) return std::numeric_limits<double>::infinity();
+    const double cost = m_countCycles ? static_cast<double>(cut.cycles)/cut.nEvaluated() : 1.0;
+    return cost*cut.nEvaluated()/cut.nFail;
+  };
+  std::vector<const Cut*> order;
+  for ( const auto& cut : m_cuts ) order.push_back(&cut);
+  std::stable_sort(order.begin(),order.end(),[&score](const Cut* a, const Cut* b) {
+      return score(*a) < score(*b);
+    });
+  std::vector<std::string> names;
+  for ( const auto cut : order ) names.push_back(cut->name);
+  return names;
+}
+
+TH1D* xTRT::CutFlow::makeHistogram() const {
+  const int nbins = m_cuts.size() + 1;
+  const std::string hname = "CutFlow_" + m_name;
+  auto hist = new TH1D(hname.c_str(),(m_name + ";;objects").c_str(),nbins,0,nbins);
+  hist->GetXaxis()->SetBinLabel(1,"all");
+  hist->SetBinContent(1,m_nObjects);
+  for ( std::size_t i = 0; i < m_cuts.size(); ++i ) {
+    hist->GetXaxis()->SetBinLabel(i+2,m_cuts[i].name.c_str());
+    hist->SetBinContent(i+2,m_cuts[i].nPass);
+  }
+  return hist;
+}
+
+bool xTRT::writeCutFlowJSON(const std::string& fileName, const std::vector<const xTRT::CutFlow*>& flows) {
+  nlohmann::json report;
+  for ( const auto flow : flows ) {
+    auto& entry = report[flow->name()];
+    entry["nObjects"]  = flow->nObjects();
+    entry["nAccepted"] = flow->nAccepted();
+    entry["cuts"]      = nlohmann::json::array();
+    for ( const auto& cut : flow->cuts() ) {
+      nlohmann::json jcut = {{"name",cut.name},{"nPass",cut.nPass},{"nFail",cut.nFail}};
+      if ( flow->countCycles() ) {
+        jcut["cycles"] = cut.cycles;
+        jcut["cyclesPerObject"] = ( cut.nEvaluated() > 0 ) ? static_cast<double>(cut.cycles)/cut.nEvaluated() : 0.0;
+      }
+      entry["cuts"].push_back(jcut);
+    }
+    entry["suggestedOrder"] = flow->suggestedOrder();
+  }
+  std::ofstream out(fileName);
+  if ( not out ) {
+    XTRT_WARNING("CutFlow: cannot open " << fileName);
+    return false;
+  }
+  out << report.dump(2) << std::endl;
+  return static_cast<bool>(out);
+}
+
+bool xTRT::mergeCutFlowJSON(const std::vector<std::string>& inputs, const std::string& output) {
+  std::vector<std::unique_ptr<xTRT::CutFlow>> flows;
+  for ( const auto& fileName : inputs ) {
+    std::ifstream in(fileName);
+    if ( not in ) {
+      XTRT_WARNING("CutFlow: cannot open " << fileName);
+      return false;
+    }
+    try {
+      nlohmann::json report;
+      in >> report;
+      for ( auto itr = report.begin(); itr != report.end(); ++itr ) {
+        const auto& entry = itr.value();
+        std::vector<xTRT::CutFlow::Cut> cuts;
+        bool cycles = false;
+        for ( const auto& jcut : entry.at("cuts") ) {
+          xTRT::CutFlow::Cut cut;
+          cut.name  = jcut.at("name").get<std::string>();
+          cut.nPass = jcut.at("nPass").get<uint64_t>();
+          cut.nFail = jcut.at("nFail").get<uint64_t>();
+          if ( jcut.count("cycles") ) {
+            cut.cycles = jcut.at("cycles").get<uint64_t>();
+            cycles = true;
+          }
+          cuts.push_back(cut);
+        }
+        auto flow = std::find_if(flows.begin(),flows.end(),[&itr](const std::unique_ptr<xTRT::CutFlow>& f) {
+            return f->name() == itr.key();
+          });
+        if ( flow == flows.end() ) {
+          flows.emplace_back(std::make_unique<xTRT::CutFlow>(itr.key(),cycles));
+          flow = flows.end() - 1;
+        }
+        (*flow)->add(cuts,entry.at("nObjects").get<uint64_t>(),entry.at("nAccepted").get<uint64_t>());
+      }
+    }
+    catch ( const std::exception& e ) {
+      XTRT_WARNING("CutFlow: bad report " << fileName << ": " << e.what());
+      return false;
+    }
+  }
+  std::vector<const xTRT::CutFlow*> merged;
+  for ( const auto& flow : flows ) merged.push_back(flow.get());
+  return xTRT::writeCutFlowJSON(output,merged);
+}
@@ -0,0 +1,97 @@
+#include <xTRTFrame/FillBuffer.h>
+
+#include <TAxis.h>
+
+#include <algorithm>
+#include <chrono>
+
+xTRT::FillBuffer::FillBuffer(TH1* hist, const std::size_t capacity, const bool prebinned,
+                             const std::size_t referenceSample) :
+  m_hist(hist), m_capacity(capacity > 0 ? capacity : 1),
+  m_direct(false), m_prebinned(false),
+  m_nbins(0), m_xmin(0), m_xmax(0),
+  m_referenceSample(referenceSample) {
+  if ( hist->GetDimension() != 1 || hist->InheritsFrom("TProfile") ) {
+    m_direct = true;
+    return;
+  }
+  m_x.reserve(m_capacity);
+  m_w.reserve(m_capacity);
+  const TAxis* axis = hist->GetXaxis();
+  if ( prebinned && !axis->IsVariableBinSize() && !hist->CanExtendAllAxes() ) {
+    m_prebinned = true;
+    m_nbins = axis->GetNbins();
+    m_xmin  = axis->GetXmin();
+    m_xmax  = axis->GetXmax();
+  }
+}
+
+void xTRT::FillBuffer::fillReference() {
+  if ( m_nReference >= m_referenceSample ) return;
+  if ( not m_reference ) {
+    m_reference.reset(static_cast<TH1*>(m_hist->Clone()));
+    m_reference->SetDirectory(nullptr);
+    m_reference->Reset();
+  }
+  const std::size_t n = std::min(m_x.size(),m_referenceSample - m_nReference);
+  auto start = std::chrono::steady_clock::now();
+  for ( std::size_t i = 0; i < n; ++i ) {
+    m_reference->Fill(m_x[i],m_w[i]);
+  }
+  auto stop = std::chrono::steady_clock::now();
+  m_referenceSeconds += std::chrono::duration<double>(stop-start).count();
+  m_nReference       += n;
+  if ( m_nReference >= m_referenceSample ) m_reference.reset();
+}
+
+void xTRT::FillBuffer::flushPrebinned() {
+  // before the loop: with no in range statistics yet ROOT rebuilds
+  // them from the bin contents, which must not include this batch
+  double stats[13] = {0};
+  m_hist->GetStats(stats);
+  TArrayD* sumw2 = ( m_hist->GetSumw2N() > 0 ) ? m_hist->GetSumw2() : nullptr;
+  double sumw = 0, sumw2tot = 0, sumwx = 0, sumwx2 = 0;
+  const double width = m_xmax - m_xmin;
+  const std::size_t n = m_x.size();
+  for ( std::size_t i = 0; i < n; ++i ) {
+    const double x = m_x[i];
+    const double w = m_w[i];
+    int bin;
+    // TAxis::FindFixBin for a fixed width axis
+    if      ( x <  m_xmin ) bin = 0;
+    else if ( !(x < m_xmax) ) bin = m_nbins + 1;
+    else                    bin = 1 + int(m_nbins*(x-m_xmin)/width);
+    m_hist->AddBinContent(bin,w);
+    if ( sumw2 ) sumw2->fArray[bin] += w*w;
+    // statistics only count in range entries (TH1 default)
+    if ( bin > 0 && bin <= m_nbins ) {
+      sumw     += w;
+      sumw2tot += w*w;
+      sumwx    += w*x;
+      sumwx2   += w*x*x;
+    }
+  }
+  stats[0] += sumw;
+  stats[1] += sumw2tot;
+  stats[2] += sumwx;
+  stats[3] += sumwx2;
+  m_hist->PutStats(stats);
+  m_hist->SetEntries(m_hist->GetEntries() + n);
+}
+
+void xTRT::FillBuffer::flush() {
+  if ( m_x.empty() ) return;
+  fillReference();
+  auto start = std::chrono::steady_clock::now();
+  if ( m_prebinned ) {
+    flushPrebinned();
+  }
+  else {
+    m_hist->FillN(static_cast<int>(m_x.size()),m_x.data(),m_w.data());
+  }
+  auto stop = std::chrono::steady_clock::now();
+  m_seconds  += std::chrono::duration<double>(stop-start).count();
+  m_nEntries += m_x.size();
+  m_x.clear();
+  m_w.clear();
+}
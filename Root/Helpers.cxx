@@ -3,30 +3,16 @@
 #include <cmath>
 
 xTRT::StrawRegion xTRT::getStrawRegion(const float eta) {
-  float absEta = std::fabs(eta);
-  if      ( absEta < 0.625 )  return xTRT::StrawRegion::BRL;
-  else if ( absEta < 1.070 )  return xTRT::StrawRegion::BRLECA;
-  else if ( absEta < 1.304 )  return xTRT::StrawRegion::ECA;
-  else if ( absEta < 1.752 )  return xTRT::StrawRegion::ECAECB;
-  else if ( absEta < 2.000 )  return xTRT::StrawRegion::ECB;
-  else                        return xTRT::StrawRegion::NOTTRT;
+  return static_cast<xTRT::StrawRegion>(xTRT::strawRegionCode(std::fabs(eta)));
 }
 
 xTRT::SideRegion xTRT::getSideRegion(const int bec) {
-  switch ( bec ) {
-  case -2:
-    return xTRT::SideRegion::SIDE_C;
-  case -1:
-  case  1:
-    return xTRT::SideRegion::BARREL;
-  case  2:
-    return xTRT::SideRegion::SIDE_A;
-  default:
+  const int side = xTRT::sideRegionCode(bec);
+  if ( side == xTRT::SideRegion::NONTRT ) {
     std::string msg = "bad value for bec: " + std::to_string(bec);
     XTRT_FATAL(msg);
-    break;
   }
-  return xTRT::SideRegion::NONTRT;
+  return static_cast<xTRT::SideRegion>(side);
 }
 
 xTRT::SideRegion xTRT::getSideRegion(const xAOD::TrackMeasurementValidation* dc) {
@@ -41,23 +27,44 @@ xTRT::SideRegion xTRT::getSideRegion(const xAOD::TrackMeasurementValidation* dc)
 }
 
 int xTRT::absoluteBarrelSL(const int sl, const int layer) {
-  int abs_SL = sl;
-  if ( layer > 0 )
-    abs_SL += 19;
-  if ( layer > 1 )
-    abs_SL += 24;
-  if ( layer > 2 || abs_SL > 72 )
+  if ( layer > 2 )
+    XTRT_FATAL("absoluteBarrelSL: Layer information is bad!");
+  const int abs_SL = sl + ( layer > 0 ? xTRT::Lookup::strawLayerOffset[0][layer] : 0 );
+  if ( abs_SL > 72 )
     XTRT_FATAL("absoluteBarrelSL: Layer information is bad!");
   return abs_SL;
 }
 
 int xTRT::absoluteEndCapSL(const int sl, const int wheel) {
-  int abs_SL = sl;
-  if ( wheel < 6 )
-    abs_SL += 16 * wheel;
-  else
-    abs_SL += 96 + (wheel - 6) * 8;
+  if ( wheel < 0 || wheel > 13 )
+    XTRT_FATAL("absoluteEndCapSL: Layer information is bad!");
+  const int abs_SL = sl + xTRT::Lookup::strawLayerOffset[1][wheel];
   if ( abs_SL > 159 )
     XTRT_FATAL("absoluteEndCapSL: Layer information is bad!")
   return abs_SL;
 }
+
+void xTRT::absoluteStrawLayers(const int* bec, const int* layer, const int* sl,
+                               const std::size_t n, int* absSL) {
+  for ( std::size_t i = 0; i < n; ++i ) {
+    absSL[i] = xTRT::absoluteStrawLayer(bec[i],layer[i],sl[i]);
+  }
+}
+
+void xTRT::layerRegionCodes(const int* bec, const int* layer, const std::size_t n, int* region) {
+  for ( std::size_t i = 0; i < n; ++i ) {
+    region[i] = xTRT::layerRegionCode(bec[i],layer[i]);
+  }
+}
+
+void xTRT::sideRegionCodes(const int* bec, const std::size_t n, int* side) {
+  for ( std::size_t i = 0; i < n; ++i ) {
+    side[i] = xTRT::sideRegionCode(bec[i]);
+  }
+}
+
+void xTRT::strawRegionCodes(const float* eta, const std::size_t n, int* region) {
+  for ( std::size_t i = 0; i < n; ++i ) {
+    region[i] = xTRT::strawRegionCode(std::fabs(eta[i]));
+  }
+}
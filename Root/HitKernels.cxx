@@ -0,0 +1,207 @@
+#include <xTRTFrame/HitKernels.h>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define XTRT_HITKERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+  // pi split in three parts for the Cody-Waite argument reduction
+  constexpr float kPiA   = 3.140625f;
+  constexpr float kPiB   = 9.67502593994140625e-4f;
+  constexpr float kPiC   = 1.509957990978376432e-7f;
+  constexpr float kInvPi = 0.318309886183790671538f;
+  constexpr float kPiO2  = 1.57079632679489661923f;
+  constexpr float kPiO4  = 0.785398163397448309616f;
+
+  // cephes minimax coefficients for sin and cos on [0,pi/4]
+  constexpr float kSin0 = -1.9515295891e-4f;
+  constexpr float kSin1 =  8.3321608736e-3f;
+  constexpr float kSin2 = -1.6666654611e-1f;
+  constexpr float kCos0 =  2.443315711809948e-5f;
+  constexpr float kCos1 = -1.388731625493765e-3f;
+  constexpr float kCos2 =  4.166664568298827e-2f;
+
+  // 1-sin^2(theta)*cos^2(dphi) is evaluated as
+  // cos^2(theta)+sin^2(theta)*sin^2(dphi) everywhere: same value, but
+  // no cancellation for tracks at grazing incidence in the end caps.
+  inline float lengthScalar(const float r, const float localPhi, const int bec,
+                            const double sinTheta, const double cosTheta, const float trackPhi) {
+    const double chord = 2*std::sqrt(4.0-(double)r*r);
+    if ( std::abs(bec) != 2 ) {
+      return chord/std::fabs(sinTheta);
+    }
+    const double sindphi = std::sin((double)trackPhi-(double)localPhi);
+    return chord/std::sqrt(cosTheta*cosTheta+sinTheta*sinTheta*sindphi*sindphi);
+  }
+
+#ifdef XTRT_HITKERNELS_X86
+
+  __attribute__((target("avx2,fma")))
+  void lengthAVX2(const float* rTrkWire, const float* localPhi, const int* bec,
+                  const std::size_t n, const float trackTheta, const float trackPhi,
+                  float* L) {
+    const double sinTheta = std::sin((double)trackTheta);
+    const double cosTheta = std::cos((double)trackTheta);
+    const __m256 invAbsSin = _mm256_set1_ps(1.0/std::fabs(sinTheta));
+    const __m256 sin2      = _mm256_set1_ps(sinTheta*sinTheta);
+    const __m256 cos2      = _mm256_set1_ps(cosTheta*cosTheta);
+    const __m256 phiTrk    = _mm256_set1_ps(trackPhi);
+    const __m256 one       = _mm256_set1_ps(1.0f);
+    const __m256 two       = _mm256_set1_ps(2.0f);
+    const __m256 four      = _mm256_set1_ps(4.0f);
+    const __m256 half      = _mm256_set1_ps(0.5f);
+    const __m256 absMask   = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256i ecPos    = _mm256_set1_epi32(2);
+    const __m256i ecNeg    = _mm256_set1_epi32(-2);
+
+    std::size_t i = 0;
+    for ( ; i + 8 <= n; i += 8 ) {
+      const __m256 r     = _mm256_loadu_ps(rTrkWire+i);
+      const __m256 chord = _mm256_mul_ps(two,_mm256_sqrt_ps(_mm256_fnmadd_ps(r,r,four)));
+
+      // reduce phi difference to [-pi/2,pi/2], cos^2 has period pi
+      __m256 x = _mm256_sub_ps(phiTrk,_mm256_loadu_ps(localPhi+i));
+      const __m256 k = _mm256_round_ps(_mm256_mul_ps(x,_mm256_set1_ps(kInvPi)),
+                                       _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      x = _mm256_fnmadd_ps(k,_mm256_set1_ps(kPiA),x);
+      x = _mm256_fnmadd_ps(k,_mm256_set1_ps(kPiB),x);
+      x = _mm256_fnmadd_ps(k,_mm256_set1_ps(kPiC),x);
+
+      // |sin(x)| = sin(|x|) for |x| < pi/4, cos(pi/2-|x|) above
+      const __m256 ax  = _mm256_and_ps(x,absMask);
+      const __m256 big = _mm256_cmp_ps(ax,_mm256_set1_ps(kPiO4),_CMP_GT_OQ);
+      const __m256 t   = _mm256_blendv_ps(ax,_mm256_sub_ps(_mm256_set1_ps(kPiO2),ax),big);
+      const __m256 z   = _mm256_mul_ps(t,t);
+      __m256 sinp = _mm256_fmadd_ps(_mm256_set1_ps(kSin0),z,_mm256_set1_ps(kSin1));
+      sinp = _mm256_fmadd_ps(sinp,z,_mm256_set1_ps(kSin2));
+      sinp = _mm256_fmadd_ps(_mm256_mul_ps(sinp,z),t,t);
+      __m256 cosp = _mm256_fmadd_ps(_mm256_set1_ps(kCos0),z,_mm256_set1_ps(kCos1));
+      cosp = _mm256_fmadd_ps(cosp,z,_mm256_set1_ps(kCos2));
+      cosp = _mm256_fmadd_ps(_mm256_mul_ps(cosp,z),z,_mm256_fnmadd_ps(half,z,one));
+      const __m256 s = _mm256_blendv_ps(sinp,cosp,big);
+
+      // 1-sin^2(theta)*cos^2(x) written without the cancellation
+      const __m256 den = _mm256_sqrt_ps(_mm256_fmadd_ps(sin2,_mm256_mul_ps(s,s),cos2));
+      const __m256 Lec = _mm256_div_ps(chord,den);
+      const __m256 Lbr = _mm256_mul_ps(chord,invAbsSin);
+
+      const __m256i b    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bec+i));
+      const __m256i isEC = _mm256_or_si256(_mm256_cmpeq_epi32(b,ecPos),_mm256_cmpeq_epi32(b,ecNeg));
+      _mm256_storeu_ps(L+i,_mm256_blendv_ps(Lbr,Lec,_mm256_castsi256_ps(isEC)));
+    }
+    for ( ; i < n; ++i ) {
+      L[i] = lengthScalar(rTrkWire[i],localPhi[i],bec[i],sinTheta,cosTheta,trackPhi);
+    }
+  }
+
+  void lengthSSE2(const float* rTrkWire, const float* localPhi, const int* bec,
+                  const std::size_t n, const float trackTheta, const float trackPhi,
+                  float* L) {
+    const double sinTheta = std::sin((double)trackTheta);
+    const double cosTheta = std::cos((double)trackTheta);
+    const __m128 invAbsSin = _mm_set1_ps(1.0/std::fabs(sinTheta));
+    const __m128 sin2      = _mm_set1_ps(sinTheta*sinTheta);
+    const __m128 cos2      = _mm_set1_ps(cosTheta*cosTheta);
+    const __m128 phiTrk    = _mm_set1_ps(trackPhi);
+    const __m128 one       = _mm_set1_ps(1.0f);
+    const __m128 two       = _mm_set1_ps(2.0f);
+    const __m128 four      = _mm_set1_ps(4.0f);
+    const __m128 half      = _mm_set1_ps(0.5f);
+    const __m128 absMask   = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128i ecPos    = _mm_set1_epi32(2);
+    const __m128i ecNeg    = _mm_set1_epi32(-2);
+
+    // SSE2 has no blendv: select with and/andnot/or
+    auto select = [](const __m128 a, const __m128 b, const __m128 mask) {
+      return _mm_or_ps(_mm_andnot_ps(mask,a),_mm_and_ps(mask,b));
+    };
+
+    std::size_t i = 0;
+    for ( ; i + 4 <= n; i += 4 ) {
+      const __m128 r     = _mm_loadu_ps(rTrkWire+i);
+      const __m128 chord = _mm_mul_ps(two,_mm_sqrt_ps(_mm_sub_ps(four,_mm_mul_ps(r,r))));
+
+      __m128 x = _mm_sub_ps(phiTrk,_mm_loadu_ps(localPhi+i));
+      const __m128 k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x,_mm_set1_ps(kInvPi))));
+      x = _mm_sub_ps(x,_mm_mul_ps(k,_mm_set1_ps(kPiA)));
+      x = _mm_sub_ps(x,_mm_mul_ps(k,_mm_set1_ps(kPiB)));
+      x = _mm_sub_ps(x,_mm_mul_ps(k,_mm_set1_ps(kPiC)));
+
+      const __m128 ax  = _mm_and_ps(x,absMask);
+      const __m128 big = _mm_cmpgt_ps(ax,_mm_set1_ps(kPiO4));
+      const __m128 t   = select(ax,_mm_sub_ps(_mm_set1_ps(kPiO2),ax),big);
+      const __m128 z   = _mm_mul_ps(t,t);
+      __m128 sinp = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kSin0),z),_mm_set1_ps(kSin1));
+      sinp = _mm_add_ps(_mm_mul_ps(sinp,z),_mm_set1_ps(kSin2));
+      sinp = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinp,z),t),t);
+      __m128 cosp = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kCos0),z),_mm_set1_ps(kCos1));
+      cosp = _mm_add_ps(_mm_mul_ps(cosp,z),_mm_set1_ps(kCos2));
+      cosp = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cosp,z),z),_mm_sub_ps(one,_mm_mul_ps(half,z)));
+      const __m128 s = select(sinp,cosp,big);
+
+      const __m128 den = _mm_sqrt_ps(_mm_add_ps(cos2,_mm_mul_ps(sin2,_mm_mul_ps(s,s))));
+      const __m128 Lec = _mm_div_ps(chord,den);
+      const __m128 Lbr = _mm_mul_ps(chord,invAbsSin);
+
+      const __m128i b    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bec+i));
+      const __m128i isEC = _mm_or_si128(_mm_cmpeq_epi32(b,ecPos),_mm_cmpeq_epi32(b,ecNeg));
+      _mm_storeu_ps(L+i,select(Lbr,Lec,_mm_castsi128_ps(isEC)));
+    }
+    for ( ; i < n; ++i ) {
+      L[i] = lengthScalar(rTrkWire[i],localPhi[i],bec[i],sinTheta,cosTheta,trackPhi);
+    }
+  }
+
+#endif
+
+  typedef void (*LengthKernel)(const float*, const float*, const int*,
+                               const std::size_t, const float, const float, float*);
+
+  struct LengthImpl {
+    LengthKernel kernel;
+    const char*  name;
+  };
+
+  LengthImpl pickLengthImpl() {
+#ifdef XTRT_HITKERNELS_X86
+    if ( std::getenv("XTRT_NO_SIMD") == nullptr ) {
+      __builtin_cpu_init();
+      if ( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ) {
+        return {lengthAVX2,"AVX2"};
+      }
+      return {lengthSSE2,"SSE2"};
+    }
+#endif
+    return {xTRT::trackLengthInStrawScalar,"scalar"};
+  }
+
+  const LengthImpl& lengthImpl() {
+    static const LengthImpl impl = pickLengthImpl();
+    return impl;
+  }
+
+}
+
+void xTRT::trackLengthInStraw(const float* rTrkWire, const float* localPhi, const int* bec,
+                              const std::size_t n, const float trackTheta, const float trackPhi,
+                              float* L) {
+  lengthImpl().kernel(rTrkWire,localPhi,bec,n,trackTheta,trackPhi,L);
+}
+
+void xTRT::trackLengthInStrawScalar(const float* rTrkWire, const float* localPhi, const int* bec,
+                                    const std::size_t n, const float trackTheta, const float trackPhi,
+                                    float* L) {
+  const double sinTheta = std::sin((double)trackTheta);
+  const double cosTheta = std::cos((double)trackTheta);
+  for ( std::size_t i = 0; i < n; ++i ) {
+    L[i] = lengthScalar(rTrkWire[i],localPhi[i],bec[i],sinTheta,cosTheta,trackPhi);
+  }
+}
+
+const char* xTRT::trackLengthInStrawImpl() {
+  return lengthImpl().name;
+}
@@ -0,0 +1,124 @@
+#include <xTRTFrame/HitNtupleWriter.h>
+
+#include <TTree.h>
+#include <TBranch.h>
+
+#include <algorithm>
+
+template <class T>
+void xTRT::HitNtupleWriter::addColumn(const std::string& name, std::vector<T>& column,
+                                      const char type, const char* count, const int basketSize) {
+  // keep data() valid (non null) for the first fill
+  column.reserve(64);
+  const std::string leaf = name + "[" + count + "]/" + type;
+  TBranch* branch = m_tree->Branch(name.c_str(),column.data(),leaf.c_str(),basketSize);
+  branch->SetCompressionSettings(m_compression);
+  m_bindings.push_back({branch,&column,&columnData<T>});
+}
+
+void xTRT::HitNtupleWriter::addScalar(const std::string& name, void* address, const char type) {
+  const std::string leaf = name + "/" + type;
+  TBranch* branch = m_tree->Branch(name.c_str(),address,leaf.c_str());
+  branch->SetCompressionSettings(m_compression);
+}
+
+xTRT::HitNtupleWriter::HitNtupleWriter(TTree* tree, const int basketSize,
+                                       const long long autoFlush, const int compression) :
+  m_tree(tree), m_compression(compression) {
+
+  const int trkBasket = std::max(basketSize/8,32000);
+
+  addScalar("weight", &m_weight, 'F');
+  addScalar("mu",     &m_mu,     'F');
+  addScalar("nTracks",&m_nTracks,'i');
+  addScalar("nHits",  &m_nHits,  'i');
+
+  addColumn("trk_pT",          m_trk_pT,          'F',"nTracks",trkBasket);
+  addColumn("trk_eta",         m_trk_eta,         'F',"nTracks",trkBasket);
+  addColumn("trk_p",           m_trk_p,           'F',"nTracks",trkBasket);
+  addColumn("trk_theta",       m_trk_theta,       'F',"nTracks",trkBasket);
+  addColumn("trk_nTRTHits",    m_trk_nTRTHits,    'b',"nTracks",trkBasket);
+  addColumn("trk_nTRTOutliers",m_trk_nTRTOutliers,'b',"nTracks",trkBasket);
+  addColumn("trk_nTRTHTHits",  m_trk_nTRTHTHits,  'b',"nTracks",trkBasket);
+  addColumn("trk_nPixelHits",  m_trk_nPixelHits,  'b',"nTracks",trkBasket);
+  addColumn("trk_nSCTHits",    m_trk_nSCTHits,    'b',"nTracks",trkBasket);
+  addColumn("trk_hitBegin",    m_trk_hitBegin,    'i',"nTracks",trkBasket);
+
+  addColumn("hit_bits",        m_hit_bits,        'b',"nHits",basketSize);
+  addColumn("hit_bec",         m_hit_bec,         'B',"nHits",basketSize);
+  addColumn("hit_layer",       m_hit_layer,       'b',"nHits",basketSize);
+  addColumn("hit_strawlayer",  m_hit_strawlayer,  'b',"nHits",basketSize);
+  addColumn("hit_phi_module",  m_hit_phi_module,  'b',"nHits",basketSize);
+  addColumn("hit_strawnumber", m_hit_strawnumber, 'b',"nHits",basketSize);
+  addColumn("hit_type",        m_hit_type,        'b',"nHits",basketSize);
+  addColumn("hit_drifttime",   m_hit_drifttime,   'F',"nHits",basketSize);
+  addColumn("hit_tot",         m_hit_tot,         'F',"nHits",basketSize);
+  addColumn("hit_T0",          m_hit_T0,          'F',"nHits",basketSize);
+  addColumn("hit_localX",      m_hit_localX,      'F',"nHits",basketSize);
+  addColumn("hit_localY",      m_hit_localY,      'F',"nHits",basketSize);
+  addColumn("hit_localTheta",  m_hit_localTheta,  'F',"nHits",basketSize);
+  addColumn("hit_localPhi",    m_hit_localPhi,    'F',"nHits",basketSize);
+  addColumn("hit_HitZ",        m_hit_HitZ,        'F',"nHits",basketSize);
+  addColumn("hit_HitR",        m_hit_HitR,        'F',"nHits",basketSize);
+  addColumn("hit_rTrkWire",    m_hit_rTrkWire,    'F',"nHits",basketSize);
+  addColumn("hit_L",           m_hit_L,           'F',"nHits",basketSize);
+
+  m_tree->SetAutoFlush(autoFlush);
+}
+
+void xTRT::HitNtupleWriter::addTrack(const xTRT::TrackSummary& track, const xTRT::HitBlock& hits) {
+  m_trk_pT.push_back(track.pT);
+  m_trk_eta.push_back(track.eta);
+  m_trk_p.push_back(track.p);
+  m_trk_theta.push_back(track.theta);
+  m_trk_nTRTHits.push_back(track.nTRTHits);
+  m_trk_nTRTOutliers.push_back(track.nTRTOutliers);
+  m_trk_nTRTHTHits.push_back(track.nTRTHTHits);
+  m_trk_nPixelHits.push_back(track.nPixelHits);
+  m_trk_nSCTHits.push_back(track.nSCTHits);
+  m_trk_hitBegin.push_back(m_nHits);
+  m_nTracks++;
+
+  const std::size_t n = hits.size();
+  for ( std::size_t i = 0; i < n; ++i ) {
+    m_hit_bits.push_back(static_cast<uint8_t>((hits.HTMB[i] & 1) | ((hits.gasType[i] & 3) << 1)));
+    m_hit_bec.push_back(static_cast<int8_t>(hits.bec[i]));
+    m_hit_layer.push_back(static_cast<uint8_t>(hits.layer[i]));
+    m_hit_strawlayer.push_back(static_cast<uint8_t>(hits.strawlayer[i]));
+    m_hit_phi_module.push_back(static_cast<uint8_t>(hits.phi_module[i]));
+    m_hit_strawnumber.push_back(static_cast<uint8_t>(hits.strawnumber[i]));
+    m_hit_type.push_back(static_cast<uint8_t>(hits.type[i]));
+  }
+  m_hit_drifttime.insert(m_hit_drifttime.end(),hits.drifttime.begin(),hits.drifttime.end());
+  m_hit_tot.insert(m_hit_tot.end(),hits.tot.begin(),hits.tot.end());
+  m_hit_T0.insert(m_hit_T0.end(),hits.T0.begin(),hits.T0.end());
+  m_hit_localX.insert(m_hit_localX.end(),hits.localX.begin(),hits.localX.end());
+  m_hit_localY.insert(m_hit_localY.end(),hits.localY.begin(),hits.localY.end());
+  m_hit_localTheta.insert(m_hit_localTheta.end(),hits.localTheta.begin(),hits.localTheta.end());
+  m_hit_localPhi.insert(m_hit_localPhi.end(),hits.localPhi.begin(),hits.localPhi.end());
+  m_hit_HitZ.insert(m_hit_HitZ.end(),hits.HitZ.begin(),hits.HitZ.end());
+  m_hit_HitR.insert(m_hit_HitR.end(),hits.HitR.begin(),hits.HitR.end());
+  m_hit_rTrkWire.insert(m_hit_rTrkWire.end(),hits.rTrkWire.begin(),hits.rTrkWire.end());
+  m_hit_L.insert(m_hit_L.end(),hits.L.begin(),hits.L.end());
+  m_nHits += n;
+}
+
+void xTRT::HitNtupleWriter::fill() {
+  for ( auto& b : m_bindings ) {
+    b.branch->SetAddress(b.data(b.column));
+  }
+  m_tree->Fill();
+
+  m_weight  = 1.0;
+  m_mu      = 0.0;
+  m_nTracks = 0;
+  m_nHits   = 0;
+  m_trk_pT.clear(); m_trk_eta.clear(); m_trk_p.clear(); m_trk_theta.clear();
+  m_trk_nTRTHits.clear(); m_trk_nTRTOutliers.clear(); m_trk_nTRTHTHits.clear();
+  m_trk_nPixelHits.clear(); m_trk_nSCTHits.clear(); m_trk_hitBegin.clear();
+  m_hit_bits.clear(); m_hit_bec.clear(); m_hit_layer.clear(); m_hit_strawlayer.clear();
+  m_hit_phi_module.clear(); m_hit_strawnumber.clear(); m_hit_type.clear();
+  m_hit_drifttime.clear(); m_hit_tot.clear(); m_hit_T0.clear(); m_hit_localX.clear();
+  m_hit_localY.clear(); m_hit_localTheta.clear(); m_hit_localPhi.clear(); m_hit_HitZ.clear();
+  m_hit_HitR.clear(); m_hit_rTrkWire.clear(); m_hit_L.clear();
+}
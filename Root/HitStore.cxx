@@ -0,0 +1,332 @@
+#include <xTRTFrame/HitStore.h>
+#include <xTRTFrame/Utils.h>
+#include <xTRTFrame/Externals/json.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  const char        hitStoreMagic[8] = {'X','T','R','T','H','I','T','S'};
+  const std::size_t hitStorePreamble = 16; // magic, version, header size
+  const std::size_t hitStoreAlign    = 4096;
+
+  std::size_t alignUp(const std::size_t n) {
+    return (n + hitStoreAlign - 1) / hitStoreAlign * hitStoreAlign;
+  }
+
+  /// bytes per element of a column type, 0 if the type is unknown
+  std::size_t elemSize(const std::string& type) {
+    if ( type == "f32" || type == "u32" ) return 4;
+    if ( type == "u64" )                  return 8;
+    if ( type == "i8"  || type == "u8"  ) return 1;
+    return 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// writer
+////////////////////////////////////////////////////////////////////////////////
+
+xTRT::HitStoreWriter::HitStoreWriter(const std::string& fileName) : m_fileName(fileName) {
+  addColumn("trk_weight",     "f32",4);
+  addColumn("trk_pT",         "f32",4);
+  addColumn("trk_eta",        "f32",4);
+  addColumn("trk_p",          "f32",4);
+  addColumn("trk_theta",      "f32",4);
+  addColumn("trk_nTRTHits",   "u8", 1);
+  addColumn("trk_nTRTHTHits", "u8", 1);
+  addColumn("trk_hitBegin",   "u64",8);
+
+  addColumn("hit_HTMB",       "u8", 1);
+  addColumn("hit_gasType",    "u8", 1);
+  addColumn("hit_bec",        "i8", 1);
+  addColumn("hit_layer",      "u8", 1);
+  addColumn("hit_strawlayer", "u8", 1);
+  addColumn("hit_phi_module", "u8", 1);
+  addColumn("hit_strawnumber","u8", 1);
+  addColumn("hit_type",       "u8", 1);
+  addColumn("hit_drifttime",  "f32",4);
+  addColumn("hit_tot",        "f32",4);
+  addColumn("hit_T0",         "f32",4);
+  addColumn("hit_localX",     "f32",4);
+  addColumn("hit_localY",     "f32",4);
+  addColumn("hit_localTheta", "f32",4);
+  addColumn("hit_localPhi",   "f32",4);
+  addColumn("hit_HitZ",       "f32",4);
+  addColumn("hit_HitR",       "f32",4);
+  addColumn("hit_rTrkWire",   "f32",4);
+  addColumn("hit_L",          "f32",4);
+}
+
+xTRT::HitStoreWriter::~HitStoreWriter() {
+  if ( not m_closed ) close();
+}
+
+void xTRT::HitStoreWriter::addColumn(const std::string& name, const std::string& type,
+                                     const std::size_t elemSize) {
+  auto column = std::make_unique<Column>();
+  column->name     = name;
+  column->type     = type;
+  column->elemSize = elemSize;
+  column->tmpName  = m_fileName + "." + name + ".tmp";
+  column->out.open(column->tmpName,std::ios::binary | std::ios::trunc);
+  if ( not column->out ) {
+    XTRT_FATAL("HitStoreWriter: cannot open " << column->tmpName);
+  }
+  m_columns.push_back(std::move(column));
+}
+
+template <class T>
+void xTRT::HitStoreWriter::write(Column& column, const T* data, const std::size_t n) {
+  column.out.write(reinterpret_cast<const char*>(data),n*sizeof(T));
+  column.size += n;
+}
+
+template <class T, class U>
+void xTRT::HitStoreWriter::writeAs(Column& column, const std::vector<U>& data) {
+  static thread_local std::vector<T> narrowed;
+  narrowed.assign(data.begin(),data.end());
+  write(column,narrowed.data(),narrowed.size());
+}
+
+void xTRT::HitStoreWriter::addTrack(const xTRT::TrackSummary& track, const xTRT::HitBlock& hits,
+                                    const float weight) {
+  const uint8_t  nTRTHits   = track.nTRTHits;
+  const uint8_t  nTRTHTHits = track.nTRTHTHits;
+  const uint64_t hitBegin   = m_nHits;
+  auto col = m_columns.begin();
+  write(**col++,&weight,1);
+  write(**col++,&track.pT,1);
+  write(**col++,&track.eta,1);
+  write(**col++,&track.p,1);
+  write(**col++,&track.theta,1);
+  write(**col++,&nTRTHits,1);
+  write(**col++,&nTRTHTHits,1);
+  write(**col++,&hitBegin,1);
+
+  const std::size_t n = hits.size();
+  writeAs<uint8_t>(**col++,hits.HTMB);
+  writeAs<uint8_t>(**col++,hits.gasType);
+  writeAs<int8_t> (**col++,hits.bec);
+  writeAs<uint8_t>(**col++,hits.layer);
+  writeAs<uint8_t>(**col++,hits.strawlayer);
+  writeAs<uint8_t>(**col++,hits.phi_module);
+  writeAs<uint8_t>(**col++,hits.strawnumber);
+  writeAs<uint8_t>(**col++,hits.type);
+  write(**col++,hits.drifttime.data(),n);
+  write(**col++,hits.tot.data(),n);
+  write(**col++,hits.T0.data(),n);
+  write(**col++,hits.localX.data(),n);
+  write(**col++,hits.localY.data(),n);
+  write(**col++,hits.localTheta.data(),n);
+  write(**col++,hits.localPhi.data(),n);
+  write(**col++,hits.HitZ.data(),n);
+  write(**col++,hits.HitR.data(),n);
+  write(**col++,hits.rTrkWire.data(),n);
+  write(**col++,hits.L.data(),n);
+
+  m_nHits += n;
+  m_nTracks++;
+}
+
+void xTRT::HitStoreWriter::append(const xTRT::HitStoreReader& store) {
+  for ( auto& column : m_columns ) {
+    if ( column->name == "trk_hitBegin" ) {
+      // hit indices continue after the hits already in this store
+      auto begins = store.column<uint64_t>(column->name);
+      std::vector<uint64_t> shifted(begins.begin(),begins.end());
+      for ( auto& b : shifted ) b += m_nHits;
+      write(*column,shifted.data(),shifted.size());
+    }
+    else if ( column->type == "f32" ) {
+      auto data = store.column<float>(column->name);
+      write(*column,data.data(),data.size());
+    }
+    else if ( column->type == "u64" ) {
+      auto data = store.column<uint64_t>(column->name);
+      write(*column,data.data(),data.size());
+    }
+    else if ( column->type == "i8" ) {
+      auto data = store.column<int8_t>(column->name);
+      write(*column,data.data(),data.size());
+    }
+    else {
+      auto data = store.column<uint8_t>(column->name);
+      write(*column,data.data(),data.size());
+    }
+  }
+  m_nHits   += store.nHits();
+  m_nTracks += store.nTracks();
+}
+
+bool xTRT::HitStoreWriter::close() {
+  m_closed = true;
+
+  nlohmann::json header;
+  header["version"] = xTRT::hitStoreVersion;
+  header["nHits"]   = m_nHits;
+  header["nTracks"] = m_nTracks;
+  header["columns"] = nlohmann::json::array();
+  std::size_t offset = 0;
+  for ( auto& column : m_columns ) {
+    column->out.close();
+    header["columns"].push_back({{"name",column->name},{"type",column->type},
+                                 {"offset",offset},{"size",column->size}});
+    offset = alignUp(offset + column->size*column->elemSize);
+  }
+  const std::string headerStr  = header.dump();
+  const uint32_t    version    = xTRT::hitStoreVersion;
+  const uint32_t    headerSize = headerStr.size();
+
+  std::ofstream out(m_fileName,std::ios::binary | std::ios::trunc);
+  if ( not out ) {
+    XTRT_WARNING("HitStoreWriter: cannot open " << m_fileName);
+    return false;
+  }
+  out.write(hitStoreMagic,sizeof(hitStoreMagic));
+  out.write(reinterpret_cast<const char*>(&version),sizeof(version));
+  out.write(reinterpret_cast<const char*>(&headerSize),sizeof(headerSize));
+  out.write(headerStr.data(),headerSize);
+
+  const std::vector<char> zeros(hitStoreAlign,0);
+  std::vector<char> chunk(1 << 20);
+  std::size_t pos = hitStorePreamble + headerSize;
+  for ( auto& column : m_columns ) {
+    out.write(zeros.data(),alignUp(pos) - pos);
+    pos = alignUp(pos);
+    std::ifstream in(column->tmpName,std::ios::binary);
+    while ( in ) {
+      in.read(chunk.data(),chunk.size());
+      out.write(chunk.data(),in.gcount());
+      pos += in.gcount();
+    }
+    in.close();
+    std::remove(column->tmpName.c_str());
+  }
+  out.close();
+  if ( not out ) {
+    XTRT_WARNING("HitStoreWriter: failed writing " << m_fileName);
+    return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// reader
+////////////////////////////////////////////////////////////////////////////////
+
+xTRT::HitStoreReader::HitStoreReader(const std::string& fileName) : m_fileName(fileName) {
+  const int fd = ::open(fileName.c_str(),O_RDONLY);
+  if ( fd < 0 ) {
+    XTRT_FATAL("HitStoreReader: cannot open " << fileName);
+  }
+  struct stat st;
+  if ( ::fstat(fd,&st) != 0 || static_cast<std::size_t>(st.st_size) < hitStorePreamble ) {
+    ::close(fd);
+    XTRT_FATAL("HitStoreReader: bad file " << fileName);
+  }
+  m_fileSize = st.st_size;
+  void* addr = ::mmap(nullptr,m_fileSize,PROT_READ,MAP_SHARED,fd,0);
+  ::close(fd);
+  if ( addr == MAP_FAILED ) {
+    XTRT_FATAL("HitStoreReader: cannot map " << fileName);
+  }
+  m_data = static_cast<const char*>(addr);
+
+  uint32_t version, headerSize;
+  std::memcpy(&version,m_data+8,sizeof(version));
+  std::memcpy(&headerSize,m_data+12,sizeof(headerSize));
+  if ( std::memcmp(m_data,hitStoreMagic,sizeof(hitStoreMagic)) != 0 ||
+       hitStorePreamble + headerSize > m_fileSize ) {
+    XTRT_FATAL("HitStoreReader: " << fileName << " is not a hit store");
+  }
+  if ( version != xTRT::hitStoreVersion ) {
+    XTRT_FATAL("HitStoreReader: " << fileName << " has version " << version
+               << ", expected " << xTRT::hitStoreVersion);
+  }
+
+  // the header is only trusted after every column is checked to lie
+  // inside the file (a truncated file would fault in the mapping)
+  try {
+    const auto header = nlohmann::json::parse(m_data + hitStorePreamble,
+                                              m_data + hitStorePreamble + headerSize);
+    m_nHits   = header.at("nHits").get<uint64_t>();
+    m_nTracks = header.at("nTracks").get<uint64_t>();
+    const std::size_t dataStart = alignUp(hitStorePreamble + headerSize);
+    for ( const auto& column : header.at("columns") ) {
+      const std::string name = column.at("name").get<std::string>();
+      ColumnInfo info;
+      info.type   = column.at("type").get<std::string>();
+      info.offset = column.at("offset").get<std::size_t>();
+      info.size   = column.at("size").get<std::size_t>();
+      const std::size_t esize = elemSize(info.type);
+      if ( esize == 0 ) {
+        XTRT_FATAL("HitStoreReader: column " << name << " in " << fileName
+                   << " has unknown type " << info.type);
+      }
+      const std::size_t available = ( dataStart <= m_fileSize ) ? m_fileSize - dataStart : 0;
+      if ( info.offset > available || info.size > (available - info.offset)/esize ) {
+        XTRT_FATAL("HitStoreReader: column " << name << " runs past the end of " << fileName
+                   << " (truncated or partly written file?)");
+      }
+      info.offset += dataStart;
+      m_columns.emplace(name,info);
+    }
+  }
+  catch ( const std::exception& e ) {
+    XTRT_FATAL("HitStoreReader: bad header in " << fileName << ": " << e.what());
+  }
+}
+
+xTRT::HitStoreReader::~HitStoreReader() {
+  if ( m_data ) ::munmap(const_cast<char*>(m_data),m_fileSize);
+}
+
+std::vector<std::string> xTRT::HitStoreReader::columnNames() const {
+  std::vector<std::string> names;
+  for ( const auto& column : m_columns ) names.push_back(column.first);
+  return names;
+}
+
+const void* xTRT::HitStoreReader::columnData(const std::string& name, const std::string& type,
+                                             std::size_t& size) const {
+  auto itr = m_columns.find(name);
+  if ( itr == m_columns.end() ) {
+    XTRT_FATAL("HitStoreReader: no column " << name << " in " << m_fileName);
+  }
+  if ( itr->second.type != type ) {
+    XTRT_FATAL("HitStoreReader: column " << name << " is " << itr->second.type
+               << ", requested as " << type);
+  }
+  size = itr->second.size;
+  return m_data + itr->second.offset;
+}
+
+void xTRT::HitStoreReader::adviseSequential() const {
+  ::madvise(const_cast<char*>(m_data),m_fileSize,MADV_SEQUENTIAL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// utilities
+////////////////////////////////////////////////////////////////////////////////
+
+bool xTRT::isHitStore(const std::string& fileName) {
+  std::ifstream in(fileName,std::ios::binary);
+  char magic[sizeof(hitStoreMagic)];
+  if ( not in.read(magic,sizeof(magic)) ) return false;
+  return std::memcmp(magic,hitStoreMagic,sizeof(magic)) == 0;
+}
+
+bool xTRT::mergeHitStores(const std::vector<std::string>& inputs, const std::string& output) {
+  xTRT::HitStoreWriter merged(output);
+  for ( const auto& input : inputs ) {
+    xTRT::HitStoreReader store(input);
+    merged.append(store);
+  }
+  return merged.close();
+}
@@ -1,5 +1,10 @@
 #include <xTRTFrame/Runner.h>
 #include <xTRTFrame/Algorithm.h>
+#include <xTRTFrame/WorkQueue.h>
+#include <xTRTFrame/Timing.h>
+#include <xTRTFrame/CutFlow.h>
+#include <xTRTFrame/HitStore.h>
+#include <xTRTFrame/StrawAccumulator.h>
 #include <xTRTFrame/Externals/CLI11.hpp>
 
 #include <AsgTools/MsgLevel.h>
@@ -11,10 +16,269 @@
 #include <EventLoop/OutputStream.h>
 #include <SampleHandler/ScanDir.h>
 #include <SampleHandler/SampleHandler.h>
+#include <SampleHandler/SampleLocal.h>
 #include <SampleHandler/ToolsDiscovery.h>
 
 #include <xAODRootAccess/Init.h>
 
+#include <TFile.h>
+#include <TFileMerger.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+  bool fileExists(const std::string& name) {
+    return ::access(name.c_str(),F_OK) == 0;
+  }
+
+  /// merge one output file from every partial output directory into outputDir
+  /**
+   *  Objects named in skip are left out of the merge (they need a
+   *  merge of their own, see mergeStrawTrees).
+   */
+  bool mergePartialOutputs(const std::string& outputDir, const std::vector<std::string>& partDirs,
+                           const std::string& fileName, const std::vector<std::string>& skip = {}) {
+    TFileMerger merger(false);
+    bool any = false;
+    for ( const auto& dir : partDirs ) {
+      const std::string part = dir + "/" + fileName;
+      if ( not fileExists(part) ) continue;
+      merger.AddFile(part.c_str(),false);
+      any = true;
+    }
+    if ( not any ) return true;
+    const std::string merged = outputDir + "/" + fileName;
+    if ( not merger.OutputFile(merged.c_str(),"RECREATE") ) return false;
+    if ( skip.empty() ) return merger.Merge();
+    for ( const auto& name : skip ) merger.AddObjectNames(name.c_str());
+    return merger.PartialMerge(TFileMerger::kAll | TFileMerger::kRegular | TFileMerger::kSkipListed);
+  }
+
+  /// sum the StrawAccumulator trees of the partial tree outputs straw by straw
+  /**
+   *  Concatenating the trees would give one entry per straw and
+   *  range; the merged tree has one entry per straw, with the sums
+   *  of all ranges.
+   */
+  bool mergeStrawTrees(const std::string& outputDir, const std::vector<std::string>& partDirs,
+                       const std::string& fileName) {
+    std::unique_ptr<xTRT::StrawAccumulator> straws;
+    for ( const auto& dir : partDirs ) {
+      const std::string part = dir + "/" + fileName;
+      if ( not fileExists(part) ) continue;
+      std::unique_ptr<TFile> in(TFile::Open(part.c_str()));
+      if ( not in || in->IsZombie() ) return false;
+      TTree* tree = nullptr;
+      in->GetObject("StrawAccumulator",tree);
+      if ( tree == nullptr ) continue;
+      if ( not straws ) straws = std::make_unique<xTRT::StrawAccumulator>();
+      straws->add(tree);
+    }
+    if ( not straws ) return true;
+    const std::string merged = outputDir + "/" + fileName;
+    std::unique_ptr<TFile> out(TFile::Open(merged.c_str(),"UPDATE"));
+    if ( not out || out->IsZombie() ) return false;
+    auto tree = new TTree("StrawAccumulator","StrawAccumulator");
+    tree->SetDirectory(out.get());
+    straws->write(tree);
+    tree->Write();
+    out->Close();
+    return true;
+  }
+
+  /// the existing copies of a relative file name in the partial output directories
+  std::vector<std::string> partialFiles(const std::vector<std::string>& partDirs, const std::string& fileName) {
+    std::vector<std::string> parts;
+    if ( fileName.empty() || fileName[0] == '/' ) return parts;
+    for ( const auto& dir : partDirs ) {
+      const std::string part = dir + "/" + fileName;
+      if ( fileExists(part) ) parts.push_back(part);
+    }
+    return parts;
+  }
+
+  /// sum the stage timing reports of the partial output directories
+  bool mergeTimingReports(const std::string& outputDir, const std::vector<std::string>& partDirs,
+                          const std::string& fileName) {
+    const auto parts = partialFiles(partDirs,fileName);
+    if ( parts.empty() ) return true;
+    xTRT::Timing::Counters counters;
+    std::size_t nEvents = 0;
+    for ( const auto& part : parts ) {
+      if ( not xTRT::Timing::readJSON(part,counters,nEvents) ) return false;
+    }
+    std::cout << "Stage timing of " << parts.size() << " ranges:" << std::endl;
+    xTRT::Timing::printTable(std::cout,counters,nEvents);
+    return xTRT::Timing::writeJSON(outputDir + "/" + fileName,counters,nEvents);
+  }
+
+  /// sum the cut flow reports of the partial output directories
+  bool mergeCutFlowReports(const std::string& outputDir, const std::vector<std::string>& partDirs,
+                           const std::string& fileName) {
+    const auto parts = partialFiles(partDirs,fileName);
+    if ( parts.empty() ) return true;
+    return xTRT::mergeCutFlowJSON(parts,outputDir + "/" + fileName);
+  }
+
+  /// merge the hit stores written in the partial output directories, by file name
+  bool mergeHitStores(const std::string& outputDir, const std::vector<std::string>& partDirs) {
+    std::map<std::string,std::vector<std::string>> stores;
+    for ( const auto& dir : partDirs ) {
+      DIR* d = ::opendir(dir.c_str());
+      if ( d == nullptr ) continue;
+      while ( const dirent* entry = ::readdir(d) ) {
+        const std::string name = entry->d_name;
+        const std::string path = dir + "/" + name;
+        if ( name[0] != '.' && xTRT::isHitStore(path) ) stores[name].push_back(path);
+      }
+      ::closedir(d);
+    }
+    for ( const auto& store : stores ) {
+      if ( not xTRT::mergeHitStores(store.second,outputDir + "/" + store.first) ) return false;
+      std::cout << "Merged hit store " << store.first << " from " << store.second.size() << " ranges" << std::endl;
+    }
+    return true;
+  }
+
+  /// run the job over the samples with nJobs local worker processes
+  /**
+   *  The input is cut into event ranges (see xTRT::makeWorkRanges)
+   *  held in a xTRT::WorkQueue shared by nJobs forked workers. Each
+   *  worker takes the next range from the queue and runs the job on
+   *  it with a EL::DirectDriver (using the skip/max events options),
+   *  writing to outputDir/range_i, until the queue is empty. When all
+   *  workers are done the histogram outputs (hist-<sample>.root) and
+   *  tree outputs (data-<stream>/<sample>.root) are merged into
+   *  outputDir (histograms summed, tree entries concatenated, the
+   *  StrawAccumulator tree summed straw by straw) and the scheduler
+   *  summary is printed. The algorithm's own output files (hit
+   *  stores, JSON reports) go to the range directory (see
+   *  xTRT::Algorithm::setJobOutputDir); hit stores are concatenated
+   *  and the stage timing and cut flow JSON reports summed into
+   *  outputDir (reports with an absolute file name are not merged).
+   */
+  int runLocalJobs(EL::Job& job, xTRT::Algorithm* alg, const SH::SampleHandler& sh,
+                   const std::string& outputDir, const std::string& treeStream,
+                   const int nJobs, const long long rangeSize) {
+    if ( fileExists(outputDir) ) {
+      std::cout << "Output directory " << outputDir << " already exists!" << std::endl;
+      return 1;
+    }
+
+    const auto ranges = xTRT::makeWorkRanges(sh,"CollectionTree",rangeSize);
+    const int nWorkers = std::max(1,std::min<int>(nJobs,ranges.size()));
+    std::vector<std::string> rangeDirs;
+    for ( std::size_t i = 0; i < ranges.size(); ++i ) {
+      rangeDirs.push_back(outputDir + "/range_" + std::to_string(i));
+    }
+    ::mkdir(outputDir.c_str(),0755);
+
+    xTRT::WorkQueue queue(ranges.size(),nWorkers);
+    std::vector<pid_t> pids;
+    for ( int iw = 0; iw < nWorkers; ++iw ) {
+      std::cout.flush();
+      const pid_t pid = ::fork();
+      if ( pid < 0 ) {
+        std::cout << "Failed to start worker " << iw << std::endl;
+        return 1;
+      }
+      if ( pid == 0 ) {
+        int status = 0;
+        long long ir;
+        while ( status == 0 && (ir = queue.next()) >= 0 ) {
+          const auto& range = ranges[ir];
+          const double start = queue.elapsed();
+          try {
+            auto sample = new SH::SampleLocal(range.sample);
+            sample->add(range.file);
+            SH::SampleHandler rangeSH;
+            rangeSH.add(sample);
+            rangeSH.setMetaString("nc_tree","CollectionTree");
+            job.sampleHandler(rangeSH);
+            job.options()->setDouble(EL::Job::optSkipEvents,range.first);
+            job.options()->setDouble(EL::Job::optMaxEvents,range.nEntries);
+            alg->setJobOutputDir(rangeDirs[ir]);
+            EL::DirectDriver driver;
+            driver.submit(job,rangeDirs[ir]);
+          }
+          catch ( const std::exception& e ) {
+            std::cout << "Worker " << iw << " failed on " << range.file << ": " << e.what() << std::endl;
+            status = 1;
+          }
+          queue.recordRange(iw,queue.elapsed()-start,range.nEntries);
+        }
+        queue.recordFinished(iw);
+        std::cout.flush();
+        ::_exit(status);
+      }
+      pids.push_back(pid);
+    }
+
+    int nFailed = 0;
+    for ( std::size_t iw = 0; iw < pids.size(); ++iw ) {
+      int status = 0;
+      ::waitpid(pids[iw],&status,0);
+      if ( not WIFEXITED(status) || WEXITSTATUS(status) != 0 ) {
+        std::cout << "Worker " << iw << " failed" << std::endl;
+        nFailed++;
+      }
+    }
+    queue.printSummary();
+    if ( nFailed > 0 ) return 1;
+
+    // the ranges were processed largest first; merge them in input
+    // (file, first entry) order so the merged trees and hit stores
+    // have the entries in the same order as a single job
+    std::vector<std::size_t> order(ranges.size());
+    std::iota(order.begin(),order.end(),0);
+    std::sort(order.begin(),order.end(),[&ranges](const std::size_t a, const std::size_t b) {
+        if ( ranges[a].fileIndex != ranges[b].fileIndex ) return ranges[a].fileIndex < ranges[b].fileIndex;
+        return ranges[a].first < ranges[b].first;
+      });
+    std::vector<std::string> mergeDirs;
+    for ( const auto ir : order ) mergeDirs.push_back(rangeDirs[ir]);
+
+    std::set<std::string> sampleNames;
+    for ( const auto& range : ranges ) sampleNames.insert(range.sample);
+    ::mkdir((outputDir + "/data-" + treeStream).c_str(),0755);
+    for ( const auto& sample : sampleNames ) {
+      const std::string treeFile = "data-" + treeStream + "/" + sample + ".root";
+      if ( not mergePartialOutputs(outputDir,mergeDirs,"hist-" + sample + ".root") ||
+           not mergePartialOutputs(outputDir,mergeDirs,treeFile,{"StrawAccumulator"}) ||
+           not mergeStrawTrees(outputDir,mergeDirs,treeFile) ) {
+        std::cout << "Failed to merge outputs of sample " << sample << std::endl;
+        return 1;
+      }
+    }
+    if ( not mergeHitStores(outputDir,mergeDirs) ) {
+      std::cout << "Failed to merge hit stores" << std::endl;
+      return 1;
+    }
+    if ( not mergeTimingReports(outputDir,mergeDirs,alg->timingReport()) ||
+         not mergeCutFlowReports(outputDir,mergeDirs,alg->cutFlowReport()) ) {
+      std::cout << "Failed to merge the timing and cut flow reports" << std::endl;
+      return 1;
+    }
+    std::cout << "Merged outputs of " << ranges.size() << " ranges in " << outputDir << std::endl;
+    return 0;
+  }
+
+}
+
 namespace xTRT {
   int Runner(int argc, char **argv, xTRT::Algorithm* alg) {
     CLI::App app("xTRTFrame Job");
@@ -35,19 +299,50 @@ namespace xTRT {
     app.add_flag("--debug",debugMode,"Flag to run in debug mode");
     bool mcMode;
     app.add_flag("--mc",mcMode,"Flag to tell config you're running over MC (convenience flag)");
+    int nJobs = 1;
+    app.add_option("-j,--jobs",nJobs,"Number of local worker processes (with -i)");
+    long long rangeSize = 0;
+    app.add_option("--range-size",rangeSize,"Max events per work range with --jobs (0: whole files)");
+    std::string cacheSize;
+    auto o_cachesize     = app.add_option("--cache-size",cacheSize,"Input TTreeCache size in MB (Cache.Size)");
+    std::string cacheLearn;
+    auto o_cachelearn    = app.add_option("--cache-learn",cacheLearn,"Entries the TTreeCache learns from (Cache.LearnEntries)");
+    bool cachePrefetch = false;
+    app.add_flag("--cache-prefetch",cachePrefetch,"Prefetch input baskets asynchronously (Cache.AsyncPrefetch)");
+    std::string cacheBranches;
+    auto o_cachebranches = app.add_option("--cache-branches",cacheBranches,"Comma separated branches to cache (Cache.Branches)");
+    std::string cacheAuto;
+    auto o_cacheauto     = app.add_option("--cache-auto",cacheAuto,"Restrict the cache to branches read in the first N events (Cache.AutoEvents)");
+    bool timing = false;
+    app.add_flag("--timing",timing,"Time the framework stages (Timing)");
+    std::vector<std::string> overrides;
+    app.add_option("--set",overrides,"Override config options (Name=Value)");
 
     CLI11_PARSE(app, argc, argv);
 
     xAOD::Init().ignore();
 
     EL::Job job;
-    job.options()->setDouble(EL::Job::optCacheSize, 10*1024*1024);
 
     EL::OutputStream output("xTRTFrameTreeOutput");
     job.outputAdd(output);
     EL::NTupleSvc *ntuple = new EL::NTupleSvc("xTRTFrameTreeOutput");
     job.algsAdd(ntuple);
 
+    for ( const auto& ov : overrides ) {
+      const auto eq = ov.find('=');
+      if ( eq == std::string::npos || eq == 0 ) {
+        std::cout << "Bad config override " << ov << ", expected Name=Value" << std::endl;
+        return 1;
+      }
+      alg->overrideConfig(ov.substr(0,eq),ov.substr(eq+1));
+    }
+    if ( o_cachesize->count() )     alg->overrideConfig("Cache.Size",cacheSize);
+    if ( o_cachelearn->count() )    alg->overrideConfig("Cache.LearnEntries",cacheLearn);
+    if ( cachePrefetch )            alg->overrideConfig("Cache.AsyncPrefetch","YES");
+    if ( o_cachebranches->count() ) alg->overrideConfig("Cache.Branches",cacheBranches);
+    if ( o_cacheauto->count() )     alg->overrideConfig("Cache.AutoEvents",cacheAuto);
+    if ( timing )                   alg->overrideConfig("Timing","YES");
     alg->feedConfig(configFile.c_str(),printConf,mcMode);
     alg->setTreeOutputName("xTRTFrameTreeOutput");
     if ( debugMode ) {
@@ -61,6 +356,10 @@ namespace xTRT {
     if ( o_infile->count() ) {
       SH::readFileList(sh,"sample",inputTextFile);
       sh.print();
+      if ( nJobs > 1 ) {
+        return runLocalJobs(job,alg,sh,outputDir,"xTRTFrameTreeOutput",nJobs,rangeSize);
+      }
+      alg->setJobOutputDir(outputDir);
       job.sampleHandler(sh);
       EL::DirectDriver driver;
       driver.submit(job,outputDir);
@@ -0,0 +1,67 @@
+#include <xTRTFrame/SelectionEngine.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+xTRT::SelectionEngineBase::SelectionEngineBase(const std::string& name, const uint64_t learnEvents,
+                                               const uint64_t reorderPeriod) :
+  m_name(name), m_learnEvents(learnEvents), m_reorderPeriod(reorderPeriod) {}
+
+void xTRT::SelectionEngineBase::addStats(const std::string& name) {
+  m_stats.emplace_back();
+  m_stats.back().name = name;
+  m_order.push_back(m_stats.size() - 1);
+}
+
+double xTRT::SelectionEngineBase::score(const CutStats& stats) const {
+  // cuts which were never reached (or timed) get the mean cost and
+  // an even rejection, so they still get a chance to be measured
+  double meanCost = 0, nCosts = 0;
+  for ( const auto& s : m_stats ) {
+    if ( s.nTimed > 0 ) {
+      meanCost += s.cycles/s.nTimed;
+      nCosts++;
+    }
+  }
+  meanCost = ( nCosts > 0 ) ? meanCost/nCosts : 1.0;
+  const double cost = ( stats.nTimed > 0 ) ? stats.cycles/stats.nTimed : meanCost;
+  const double rejection = (stats.nFail + 1)/(stats.nEval + 2);
+  return cost/rejection;
+}
+
+void xTRT::SelectionEngineBase::reorder() {
+  std::vector<double> scores;
+  for ( const auto& s : m_stats ) scores.push_back(score(s));
+  std::stable_sort(m_order.begin(),m_order.end(),[&scores](const std::size_t a, const std::size_t b) {
+      return scores[a] < scores[b];
+    });
+  m_nReorders++;
+}
+
+void xTRT::SelectionEngineBase::newEvent() {
+  m_nEvents++;
+  if ( m_nEvents <= m_learnEvents ) {
+    reorder();
+    return;
+  }
+  if ( m_reorderPeriod > 0 && (m_nEvents - m_learnEvents) % m_reorderPeriod == 0 ) {
+    reorder();
+    // keep following the input: older measurements count half
+    for ( auto& s : m_stats ) {
+      s.nEval *= 0.5; s.nFail *= 0.5; s.nTimed *= 0.5; s.cycles *= 0.5;
+    }
+  }
+}
+
+std::string xTRT::SelectionEngineBase::describeOrder() const {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1);
+  for ( std::size_t i = 0; i < m_order.size(); ++i ) {
+    const auto& s = m_stats[m_order[i]];
+    if ( i > 0 ) out << ", ";
+    out << s.name << " (" << ( s.nTimed > 0 ? s.cycles/s.nTimed : 0.0 ) << " cycles, "
+        << ( s.nEval > 0 ? 100*s.nFail/s.nEval : 0.0 ) << "% rejected)";
+  }
+  return out.str();
+}
@@ -0,0 +1,161 @@
+#include <xTRTFrame/StrawAccumulator.h>
+
+#include <TTree.h>
+
+#include <algorithm>
+
+namespace geo = xTRT::StrawGeometry;
+
+xTRT::StrawAccumulator::StrawAccumulator() :
+  m_nHits(geo::nStraws,0), m_nHT(geo::nStraws,0),
+  m_meanToT(geo::nStraws,0), m_varToT(geo::nStraws,0),
+  m_meanDriftTime(geo::nStraws,0), m_meanT0(geo::nStraws,0) {}
+
+void xTRT::StrawAccumulator::merge(const int id, const uint32_t n, const uint32_t nHT, const double meanToT,
+                                   const double varToT, const double meanDriftTime, const double meanT0) {
+  if ( n == 0 ) return;
+  // combine the two sets of moments (Chan et al.)
+  const double na = m_nHits[id];
+  const double nb = n;
+  const double fb = nb/(na + nb);
+  const double dtot = meanToT - m_meanToT[id];
+  m_varToT[id]        = (1 - fb)*m_varToT[id] + fb*varToT + dtot*dtot*fb*(1 - fb);
+  m_meanToT[id]       = m_meanToT[id] + dtot*fb;
+  m_meanDriftTime[id] = m_meanDriftTime[id] + (meanDriftTime - m_meanDriftTime[id])*fb;
+  m_meanT0[id]        = m_meanT0[id] + (meanT0 - m_meanT0[id])*fb;
+  m_nHits[id] += n;
+  m_nHT[id]   += nHT;
+}
+
+bool xTRT::StrawAccumulator::add(const xTRT::HitSummary& hit) {
+  const int id = geo::strawId(hit.bec,hit.layer,hit.phi_module,hit.strawlayer,hit.strawnumber);
+  if ( id < 0 ) {
+    m_nRejected++;
+    return false;
+  }
+  add(id,hit.HTMB,hit.tot,hit.drifttime,hit.T0);
+  return true;
+}
+
+std::size_t xTRT::StrawAccumulator::add(const xTRT::HitBlock& block) {
+  std::size_t nAdded = 0;
+  const std::size_t n = block.size();
+  for ( std::size_t i = 0; i < n; ++i ) {
+    const int id = geo::strawId(block.bec[i],block.layer[i],block.phi_module[i],
+                                block.strawlayer[i],block.strawnumber[i]);
+    if ( id < 0 ) {
+      m_nRejected++;
+      continue;
+    }
+    add(id,block.HTMB[i],block.tot[i],block.drifttime[i],block.T0[i]);
+    nAdded++;
+  }
+  return nAdded;
+}
+
+std::size_t xTRT::StrawAccumulator::add(TTree* tree) {
+  int id;
+  uint32_t nHits, nHT;
+  double sumToT, sumToT2, sumDriftTime, sumT0;
+  tree->SetBranchAddress("id",          &id);
+  tree->SetBranchAddress("nHits",       &nHits);
+  tree->SetBranchAddress("nHT",         &nHT);
+  tree->SetBranchAddress("sumToT",      &sumToT);
+  tree->SetBranchAddress("sumToT2",     &sumToT2);
+  tree->SetBranchAddress("sumDriftTime",&sumDriftTime);
+  tree->SetBranchAddress("sumT0",       &sumT0);
+  std::size_t nAdded = 0;
+  const Long64_t nEntries = tree->GetEntries();
+  for ( Long64_t i = 0; i < nEntries; ++i ) {
+    tree->GetEntry(i);
+    if ( id < 0 || id >= geo::nStraws ) {
+      m_nRejected++;
+      continue;
+    }
+    if ( nHits > 0 ) {
+      const double meanToT = sumToT/nHits;
+      merge(id,nHits,nHT,meanToT,std::max(0.0,sumToT2/nHits - meanToT*meanToT),
+            sumDriftTime/nHits,sumT0/nHits);
+    }
+    nAdded++;
+  }
+  tree->ResetBranchAddresses();
+  return nAdded;
+}
+
+void xTRT::StrawAccumulator::clear() {
+  std::fill(m_nHits.begin(),m_nHits.end(),0);
+  std::fill(m_nHT.begin(),m_nHT.end(),0);
+  std::fill(m_meanToT.begin(),m_meanToT.end(),0);
+  std::fill(m_varToT.begin(),m_varToT.end(),0);
+  std::fill(m_meanDriftTime.begin(),m_meanDriftTime.end(),0);
+  std::fill(m_meanT0.begin(),m_meanT0.end(),0);
+  m_nRejected = 0;
+}
+
+std::size_t xTRT::StrawAccumulator::nStrawsHit() const {
+  std::size_t n = 0;
+  for ( const auto nh : m_nHits ) n += ( nh > 0 ? 1 : 0 );
+  return n;
+}
+
+std::size_t xTRT::StrawAccumulator::memoryBytes() const {
+  return geo::nStraws * (2*sizeof(uint32_t) + 4*sizeof(float));
+}
+
+void xTRT::StrawAccumulator::write(TTree* tree) const {
+  int id, bec, layer, phi_module, strawlayer, strawnumber;
+  uint32_t nHits, nHT;
+  double sumToT, sumToT2, sumDriftTime, sumT0;
+  tree->Branch("id",          &id,          "id/I");
+  tree->Branch("bec",         &bec,         "bec/I");
+  tree->Branch("layer",       &layer,       "layer/I");
+  tree->Branch("phi_module",  &phi_module,  "phi_module/I");
+  tree->Branch("strawlayer",  &strawlayer,  "strawlayer/I");
+  tree->Branch("strawnumber", &strawnumber, "strawnumber/I");
+  tree->Branch("nHits",       &nHits,       "nHits/i");
+  tree->Branch("nHT",         &nHT,         "nHT/i");
+  tree->Branch("sumToT",      &sumToT,      "sumToT/D");
+  tree->Branch("sumToT2",     &sumToT2,     "sumToT2/D");
+  tree->Branch("sumDriftTime",&sumDriftTime,"sumDriftTime/D");
+  tree->Branch("sumT0",       &sumT0,       "sumT0/D");
+
+  auto fillStraw = [&]() {
+    nHits        = m_nHits[id];
+    if ( nHits == 0 ) return;
+    nHT          = m_nHT[id];
+    sumToT       = this->sumToT(id);
+    sumToT2      = this->sumToT2(id);
+    sumDriftTime = this->sumDriftTime(id);
+    sumT0        = this->sumT0(id);
+    tree->Fill();
+  };
+
+  // walk the ids in order, decoding the identifiers on the way
+  id = 0;
+  for ( const int b : {1,-1} ) {
+    bec = b;
+    for ( phi_module = 0; phi_module < geo::nPhiModules; ++phi_module ) {
+      for ( layer = 0; layer < 3; ++layer ) {
+        for ( strawlayer = 0; strawlayer < xTRT::Lookup::nStrawLayers[0][layer]; ++strawlayer ) {
+          const int nsw = geo::barrelStrawsPerModule[xTRT::absoluteStrawLayer(bec,layer,strawlayer)];
+          for ( strawnumber = 0; strawnumber < nsw; ++strawnumber, ++id ) {
+            fillStraw();
+          }
+        }
+      }
+    }
+  }
+  for ( const int b : {2,-2} ) {
+    bec = b;
+    for ( layer = 0; layer < geo::nEndCapWheels; ++layer ) {
+      for ( strawlayer = 0; strawlayer < xTRT::Lookup::nStrawLayers[1][layer]; ++strawlayer ) {
+        for ( phi_module = 0; phi_module < geo::nPhiModules; ++phi_module ) {
+          for ( strawnumber = 0; strawnumber < geo::endCapStrawsPerModule; ++strawnumber, ++id ) {
+            fillStraw();
+          }
+        }
+      }
+    }
+  }
+}
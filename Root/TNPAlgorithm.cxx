@@ -64,6 +64,12 @@ EL::StatusCode xTRT::TNPAlgorithm::initialize() {
   m_muon_iso_ptvarcone30  = config()->getOpt<float>("TNP.Muon.ptvarcone30", 0.06);
   m_muon_iso_topoetcone20 = config()->getOpt<float>("TNP.Muon.topoetcone20",0.06);
 
+  if ( config()->cutFlow() ) {
+    m_tagCutFlow     = createCutFlow("TNPTag",config()->cutFlowCycles());
+    m_probeCutFlow   = createCutFlow("TNPProbe",config()->cutFlowCycles());
+    m_muonTNPCutFlow = createCutFlow("TNPMuon",config()->cutFlowCycles());
+  }
+
   return EL::StatusCode::SUCCESS;
 }
 
@@ -23,35 +23,42 @@ EL::StatusCode xTRT::TNPAlgorithm::performZeeSelection() {
     return EL::StatusCode::SUCCESS;
   }
 
-  const xAOD::Electron* Tag   = nullptr;
-  const xAOD::Electron* Probe = nullptr;
-  idx_t finder; // for searching vectors
-
-  // do the double loop
-  for ( std::size_t itag = 0; itag < electrons->size(); ++itag ) {
-    for ( std::size_t iprobe = 0; iprobe < electrons->size(); ++iprobe) {
-
-      // never the same particle
-      if ( itag == iprobe ) continue;
-
-      // don't get repeated probes
-      finder = std::find(m_probeIndices.begin(),m_probeIndices.end(),iprobe);
-      if ( finder != m_probeIndices.end() ) continue;
-
-      // get objects
-      Tag   = electrons->at(itag);
-      Probe = electrons->at(iprobe);
-
-      if ( not passZeeTNP(Tag,Probe) ) continue;
-
-      // all passes - save em
-      float invMass = (Tag->p4()+Probe->p4()).M();
-      m_probeIndices.push_back(iprobe);
-      m_tagIndices.push_back(itag);
-      m_invMassesEl.push_back(invMass);
-
-    }
+  // single object requirements, once per electron
+  const std::size_t nel = electrons->size();
+  m_tagCandidates.resize(nel);
+  m_probeCandidates.resize(nel);
+  m_usedProbes.resize(nel);
+  m_candP4.resize(nel);
+  m_candCharge.resize(nel);
+  for ( std::size_t i = 0; i < nel; ++i ) {
+    auto electron = electrons->at(i);
+    bool isTag   = passTagSelection(electron);
+    bool isProbe = passProbeSelection(electron);
+    if ( not (isTag or isProbe) ) continue;
+    m_tagCandidates.set(i,isTag);
+    m_probeCandidates.set(i,isProbe);
+    m_candP4[i]     = electron->p4();
+    m_candCharge[i] = electron->charge();
   }
+  if ( not m_tagCandidates.any() or not m_probeCandidates.any() ) {
+    return EL::StatusCode::SUCCESS;
+  }
+
+  // pair stage: only charge and mass left to check
+  float invMass = 0;
+  m_tagCandidates.forEach([&](const std::size_t itag) {
+      m_probeCandidates.forEach([&](const std::size_t iprobe) {
+          // never the same particle, don't get repeated probes
+          if ( itag == iprobe or m_usedProbes.test(iprobe) ) return;
+          if ( not passPair(m_candP4[itag],m_candCharge[itag],
+                            m_candP4[iprobe],m_candCharge[iprobe],invMass) ) return;
+          // all passes - save em
+          m_usedProbes.set(iprobe);
+          m_probeIndices.push_back(iprobe);
+          m_tagIndices.push_back(itag);
+          m_invMassesEl.push_back(invMass);
+        });
+    });
 
   return EL::StatusCode::SUCCESS;
 }
@@ -66,130 +73,126 @@ EL::StatusCode xTRT::TNPAlgorithm::performZmumuSelection() {
     return EL::StatusCode::SUCCESS;
   }
 
-  const xAOD::Muon* mu1 = nullptr;
-  const xAOD::Muon* mu2 = nullptr;
-  idx_t finder;
-
-  for ( std::size_t i = 0; i < muons->size(); ++i ) {
-    for ( std::size_t j = 0; j < muons->size(); ++j ) {
-
-      if ( i == j ) continue;
-
-      finder = std::find(m_muonIndices.begin(),m_muonIndices.end(),i);
-      if ( finder != m_muonIndices.end() ) continue;
-
-      mu1 = muons->at(i);
-      mu2 = muons->at(j);
-
-      if ( not passZmumuTNP(mu1,mu2) ) continue;
-
-      float invMass = (mu1->p4() + mu2->p4()).M();
-      m_muonIndices.push_back(i);
-      m_invMassesMu.push_back(invMass);
-
-    }
+  // single object requirements, once per muon
+  const std::size_t nmu = muons->size();
+  m_muonCandidates.resize(nmu);
+  m_muonTrigMatched.resize(nmu);
+  m_candP4.resize(nmu);
+  m_candCharge.resize(nmu);
+  for ( std::size_t i = 0; i < nmu; ++i ) {
+    auto muon = muons->at(i);
+    if ( not passMuonTNPSelection(muon) ) continue;
+    m_muonCandidates.set(i);
+    m_muonTrigMatched.set(i,singleMuonTrigMatched(muon));
+    m_candP4[i]     = muon->p4();
+    m_candCharge[i] = muon->charge();
+  }
+  if ( m_muonCandidates.count() < 2 or not m_muonTrigMatched.any() ) {
+    return EL::StatusCode::SUCCESS;
   }
 
+  // pair stage: each muon is saved once, with its first good partner
+  float invMass = 0;
+  m_muonCandidates.forEach([&](const std::size_t i) {
+      bool saved = false;
+      m_muonCandidates.forEach([&](const std::size_t j) {
+          if ( saved or i == j ) return;
+          // at least one single muon trigger match
+          if ( not (m_muonTrigMatched.test(i) or m_muonTrigMatched.test(j)) ) return;
+          if ( not passPair(m_candP4[i],m_candCharge[i],m_candP4[j],m_candCharge[j],invMass) ) return;
+          saved = true;
+          m_muonIndices.push_back(i);
+          m_invMassesMu.push_back(invMass);
+        });
+    });
+
   return EL::StatusCode::SUCCESS;
 }
 
-bool xTRT::TNPAlgorithm::passZeeTNP(const xAOD::Electron* Tag, const xAOD::Electron* Probe) {
-  // check if tag matches to single electron trigger
-  if ( not singleElectronTrigMatched(Tag) ) return false;
-  auto Tag_trk   = getTrack(Tag);
-  auto Probe_trk = getTrack(Probe);
-  if ( not debug_nullptr(Tag_trk,  "Tag_trk")   ) return false;
-  if ( not debug_nullptr(Probe_trk,"Probe_trk") ) return false;
-
-  float tag_pT   = Tag->pt();
-  float probe_pT = Probe->pt();
-
-  // tag must be tight LH, probe must be loose non LH
-  // both must pass author
-  if ( not (passTightLH(Tag) and passLoose(Probe)) ) return false;
-  if ( not (passAuthor(Tag) and passAuthor(Probe)) ) return false;
+bool xTRT::TNPAlgorithm::passTagSelection(const xAOD::Electron* Tag) {
+  xTRT::CutFlow::Entry cf(m_tagCutFlow);
+  // tag must be tight LH and pass author
+  if ( cf.fails("tightLH",[&]{ return not passTightLH(Tag); }) ) return false;
+  if ( cf.fails("author", [&]{ return not passAuthor(Tag); }) ) return false;
 
   // check kinematic (p, pT, eta,...) cuts
-  if ( (tag_pT*toGeV) < m_tag_pT ) return false;
-  if ( (probe_pT*toGeV) < m_probe_pT ) return false;
-  if ( Probe_trk->pt() < (m_probe_relpT*probe_pT) ) return false;
-  if ( std::abs(Tag->eta())   > 2.0 ) return false;
-  if ( std::abs(Probe->eta()) > 2.0 ) return false;
-  if ( (Tag_trk->p4().P())*toGeV > m_tag_maxP ) return false;
-  if ( (Probe_trk->p4().P())*toGeV > m_probe_maxP ) return false;
-  if ( (Tag->p4().P())*toGeV > m_tag_maxP ) return false;
-  if ( (Probe->p4().P())*toGeV > m_probe_maxP ) return false;
+  float tag_pT = Tag->pt();
+  if ( cf.fails("pT",  [&]{ return (tag_pT*toGeV) < m_tag_pT; }) ) return false;
+  if ( cf.fails("eta", [&]{ return std::abs(Tag->eta()) > 2.0; }) ) return false;
+  if ( cf.fails("maxP",[&]{ return (Tag->p4().P())*toGeV > m_tag_maxP; }) ) return false;
+
+  auto Tag_trk = getTrack(Tag);
+  if ( cf.fails("track",[&]{ return not debug_nullptr(Tag_trk,"Tag_trk"); }) ) return false;
+  auto Tag_ts = trackSummary(Tag_trk);
+  if ( cf.fails("trkMaxP",[&]{ return Tag_ts.p*toGeV > m_tag_maxP; }) ) return false;
 
   // check some track number of hits cuts
-  if ( nTRT(Tag_trk) < m_tag_nTRT ) return false;
-  if ( nTRT(Probe_trk) < m_probe_nTRT ) return false;
-  if ( nPixel(Tag_trk) < m_tag_nPix ) return false;
-  if ( nPixel(Probe_trk) < m_probe_nPix ) return false;
-  if ( nSilicon(Tag_trk) < m_tag_nSi ) return false;
-  if ( nSilicon(Probe_trk) < m_probe_nSi ) return false;
+  if ( cf.fails("nTRT",[&]{ return Tag_ts.nTRT() < m_tag_nTRT; }) ) return false;
+  if ( cf.fails("nPix",[&]{ return Tag_ts.nPixel() < m_tag_nPix; }) ) return false;
+  if ( cf.fails("nSi", [&]{ return Tag_ts.nSilicon() < m_tag_nSi; }) ) return false;
 
   // check iso cuts
-  if ( caloIso(Tag) > (m_tag_iso_topoetcone20*tag_pT) ) return false;
-  if ( trackIso(Tag) > (m_tag_iso_ptcone20*tag_pT) ) return false;
-
-  // check OS
-  if ( (Tag->charge() * Probe->charge()) > 0 ) return false;
+  if ( cf.fails("topoetcone20",[&]{ return caloIso(Tag) > (m_tag_iso_topoetcone20*tag_pT); }) ) return false;
+  if ( cf.fails("ptcone20",    [&]{ return trackIso(Tag) > (m_tag_iso_ptcone20*tag_pT); }) ) return false;
 
-  // check inv mass cuts
-  float invMass   = (Tag->p4()+Probe->p4()).M();
-  bool  inZwindow = (invMass > 80*GeV) and (invMass < 100*GeV);
-  if ( not inZwindow ) return false;
+  // check if tag matches to single electron trigger (most expensive, last)
+  if ( cf.fails("trigMatch",[&]{ return not singleElectronTrigMatched(Tag); }) ) return false;
 
-  return true;
+  return cf.accept();
 }
 
-bool xTRT::TNPAlgorithm::passZmumuTNP(const xAOD::Muon* mu1, const xAOD::Muon* mu2) {
-  // check for at least 1 single muon trig match
-  if ( not ( singleMuonTrigMatched(mu1) || singleMuonTrigMatched(mu2) ) ) return false;
+bool xTRT::TNPAlgorithm::passProbeSelection(const xAOD::Electron* Probe) {
+  xTRT::CutFlow::Entry cf(m_probeCutFlow);
+  // probe must be loose non LH and pass author
+  if ( cf.fails("loose", [&]{ return not passLoose(Probe); }) ) return false;
+  if ( cf.fails("author",[&]{ return not passAuthor(Probe); }) ) return false;
 
-  auto mu1_trk = getTrack(mu1);
-  auto mu2_trk = getTrack(mu2);
-  if ( not debug_nullptr(mu1_trk,"mu1_trk") ) return false;
-  if ( not debug_nullptr(mu2_trk,"mu2_trk") ) return false;
+  // check kinematic (p, pT, eta,...) cuts
+  float probe_pT = Probe->pt();
+  if ( cf.fails("pT",  [&]{ return (probe_pT*toGeV) < m_probe_pT; }) ) return false;
+  if ( cf.fails("eta", [&]{ return std::abs(Probe->eta()) > 2.0; }) ) return false;
+  if ( cf.fails("maxP",[&]{ return (Probe->p4().P())*toGeV > m_probe_maxP; }) ) return false;
 
-  float mu1_pT = mu1->pt();
-  float mu2_pT = mu2->pt();
+  auto Probe_trk = getTrack(Probe);
+  if ( cf.fails("track",[&]{ return not debug_nullptr(Probe_trk,"Probe_trk"); }) ) return false;
+  auto Probe_ts = trackSummary(Probe_trk);
+  if ( cf.fails("relpT",  [&]{ return Probe_ts.pT < (m_probe_relpT*probe_pT); }) ) return false;
+  if ( cf.fails("trkMaxP",[&]{ return Probe_ts.p*toGeV > m_probe_maxP; }) ) return false;
 
-  // kinematics
-  if ( mu1_trk->p4().P()*toGeV > m_muon_maxP ) return false;
-  if ( mu2_trk->p4().P()*toGeV > m_muon_maxP ) return false;
-  if ( mu1->p4().P()*toGeV > m_muon_maxP ) return false;
-  if ( mu2->p4().P()*toGeV > m_muon_maxP ) return false;
-  if ( mu1_pT*toGeV < m_muon_pT ) return false;
-  if ( mu2_pT*toGeV < m_muon_pT ) return false;
-  if ( std::abs(mu1->eta()) > 2.0 ) return false;
-  if ( std::abs(mu2->eta()) > 2.0 ) return false;
+  // check some track number of hits cuts
+  if ( cf.fails("nTRT",[&]{ return Probe_ts.nTRT() < m_probe_nTRT; }) ) return false;
+  if ( cf.fails("nPix",[&]{ return Probe_ts.nPixel() < m_probe_nPix; }) ) return false;
+  if ( cf.fails("nSi", [&]{ return Probe_ts.nSilicon() < m_probe_nSi; }) ) return false;
 
-  // hits
-  if ( nTRT(mu1_trk) < m_muon_nTRT ) return false;
-  if ( nTRT(mu2_trk) < m_muon_nTRT ) return false;
-  if ( nPixel(mu1_trk) < m_muon_nPix ) return false;
-  if ( nPixel(mu2_trk) < m_muon_nPix ) return false;
-  if ( nSilicon(mu1_trk)  < m_muon_nSi  ) return false;
-  if ( nSilicon(mu2_trk)  < m_muon_nSi  ) return false;
+  return cf.accept();
+}
+
+bool xTRT::TNPAlgorithm::passMuonTNPSelection(const xAOD::Muon* mu) {
+  xTRT::CutFlow::Entry cf(m_muonTNPCutFlow);
+  // kinematics
+  float mu_pT = mu->pt();
+  if ( cf.fails("pT",  [&]{ return mu_pT*toGeV < m_muon_pT; }) ) return false;
+  if ( cf.fails("eta", [&]{ return std::abs(mu->eta()) > 2.0; }) ) return false;
+  if ( cf.fails("maxP",[&]{ return mu->p4().P()*toGeV > m_muon_maxP; }) ) return false;
 
   // quality
-  if ( not passQuality(mu1,m_muon_nPrec) || not passQuality(mu2,m_muon_nPrec) ) return false;
+  if ( cf.fails("quality",[&]{ return not passQuality(mu,m_muon_nPrec); }) ) return false;
 
-  // iso
-  if ( caloIso(mu1) > (m_muon_iso_topoetcone20*mu1_pT) ) return false;
-  if ( caloIso(mu2) > (m_muon_iso_topoetcone20*mu2_pT) ) return false;
-  if ( trackIso(mu1) > (m_muon_iso_ptvarcone30*mu1_pT) ) return false;
-  if ( trackIso(mu2) > (m_muon_iso_ptvarcone30*mu2_pT) ) return false;
+  auto mu_trk = getTrack(mu);
+  if ( cf.fails("track",[&]{ return not debug_nullptr(mu_trk,"mu_trk"); }) ) return false;
+  auto mu_ts = trackSummary(mu_trk);
+  if ( cf.fails("trkMaxP",[&]{ return mu_ts.p*toGeV > m_muon_maxP; }) ) return false;
 
-  // check OS
-  if ( (mu1->charge() * mu2->charge()) > 0 ) return false;
+  // hits
+  if ( cf.fails("nTRT",[&]{ return mu_ts.nTRT() < m_muon_nTRT; }) ) return false;
+  if ( cf.fails("nPix",[&]{ return mu_ts.nPixel() < m_muon_nPix; }) ) return false;
+  if ( cf.fails("nSi", [&]{ return mu_ts.nSilicon() < m_muon_nSi; }) ) return false;
 
-  float invMass = (mu1->p4()+mu2->p4()).M();
-  bool  inZwindow = (invMass > 80*GeV) and (invMass < 100*GeV);
-  if ( not inZwindow ) return false;
+  // iso
+  if ( cf.fails("topoetcone20",[&]{ return caloIso(mu) > (m_muon_iso_topoetcone20*mu_pT); }) ) return false;
+  if ( cf.fails("ptvarcone30", [&]{ return trackIso(mu) > (m_muon_iso_ptvarcone30*mu_pT); }) ) return false;
 
-  return true;
+  return cf.accept();
 }
 
 EL::StatusCode xTRT::TNPAlgorithm::makeContainers() {
@@ -197,6 +200,7 @@ EL::StatusCode xTRT::TNPAlgorithm::makeContainers() {
   if ( m_containersMade ) {
     return EL::StatusCode::SUCCESS;
   }
+  xTRT::Timing::StageTimer timer(xTRT::Timing::TNP);
   ANA_CHECK(performSelections());
   auto electrons      = electronContainer();
   auto cont_tags      = std::make_unique<xAOD::ElectronContainer>();
@@ -215,6 +219,8 @@ EL::StatusCode xTRT::TNPAlgorithm::makeContainers() {
     cont_probes->push_back(aprobe);
     *aprobe = *(electrons->at(idx));
   }
+  m_tagElectrons   = cont_tags.get();
+  m_probeElectrons = cont_probes.get();
   if ( evtStore()->record(cont_tags.release(),"TNPTagElectrons").isFailure() ) {
     ANA_MSG_ERROR("Couldn't record TNPTagElectrons");
     return EL::StatusCode::FAILURE;
@@ -241,6 +247,7 @@ EL::StatusCode xTRT::TNPAlgorithm::makeContainers() {
     cont_mus->push_back(amu);
     *amu = *(muons->at(idx));
   }
+  m_goodMuons = cont_mus.get();
   if ( evtStore()->record(cont_mus.release(),"TNPMuons").isFailure() ) {
     ANA_MSG_ERROR("Couldn't record TNPMuons");
     return EL::StatusCode::FAILURE;
@@ -0,0 +1,174 @@
+#include <xTRTFrame/Timing.h>
+#include <xTRTFrame/Utils.h>
+#include <xTRTFrame/Externals/json.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+bool xTRT::Timing::detail::enabled = false;
+
+namespace {
+
+  uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+      (std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // counters of all live threads, plus those of threads which exited
+  std::mutex                            registryMutex;
+  std::vector<xTRT::Timing::Counters*>  liveCounters;
+  xTRT::Timing::Counters                retiredCounters;
+
+  struct ThreadCounters {
+    xTRT::Timing::Counters counters;
+    ThreadCounters() {
+      std::lock_guard<std::mutex> lock(registryMutex);
+      liveCounters.push_back(&counters);
+    }
+    ~ThreadCounters() {
+      std::lock_guard<std::mutex> lock(registryMutex);
+      retiredCounters.add(counters);
+      for ( auto itr = liveCounters.begin(); itr != liveCounters.end(); ++itr ) {
+        if ( *itr == &counters ) {
+          liveCounters.erase(itr);
+          break;
+        }
+      }
+    }
+  };
+
+  thread_local ThreadCounters               threadCounters;
+  thread_local xTRT::Timing::StageTimer*    currentTimer = nullptr;
+
+}
+
+const char* xTRT::Timing::stageName(const xTRT::Timing::Stage stage) {
+  switch ( stage ) {
+  case Retrieve:    return "Retrieve";
+  case Selection:   return "Selection";
+  case IDTS:        return "IDTS";
+  case Trigger:     return "Trigger";
+  case TNP:         return "TNP";
+  case Hits:        return "Hits";
+  case UserExecute: return "UserExecute";
+  default:          return "Unknown";
+  }
+}
+
+void xTRT::Timing::Counters::add(const xTRT::Timing::Counters& other) {
+  for ( std::size_t i = 0; i < NStages; ++i ) {
+    calls[i]   += other.calls[i];
+    totalNs[i] += other.totalNs[i];
+    selfNs[i]  += other.selfNs[i];
+  }
+}
+
+void xTRT::Timing::enable(const bool on) {
+  detail::enabled = on;
+}
+
+xTRT::Timing::Counters xTRT::Timing::collect() {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  Counters sum = retiredCounters;
+  for ( const auto counters : liveCounters ) {
+    sum.add(*counters);
+  }
+  return sum;
+}
+
+void xTRT::Timing::reset() {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  retiredCounters = Counters();
+  for ( const auto counters : liveCounters ) {
+    *counters = Counters();
+  }
+}
+
+void xTRT::Timing::StageTimer::start() {
+  m_parent = currentTimer;
+  currentTimer = this;
+  m_start = nowNs();
+}
+
+void xTRT::Timing::StageTimer::stop() {
+  if ( not m_active ) return;
+  m_active = false;
+  const uint64_t elapsed = nowNs() - m_start;
+  auto& counters = threadCounters.counters;
+  counters.calls[m_stage]++;
+  counters.totalNs[m_stage] += elapsed;
+  counters.selfNs[m_stage]  += ( elapsed > m_childNs ) ? elapsed - m_childNs : 0;
+  if ( m_parent ) m_parent->m_childNs += elapsed;
+  currentTimer = m_parent;
+}
+
+void xTRT::Timing::printTable(std::ostream& out, const xTRT::Timing::Counters& counters,
+                              const std::size_t nEvents) {
+  uint64_t selfSum = 0;
+  for ( std::size_t i = 0; i < NStages; ++i ) selfSum += counters.selfNs[i];
+  const double perEvent = ( nEvents > 0 ) ? 1.0/nEvents : 0.0;
+  out << std::setw(12) << "stage" << std::setw(12) << "calls" << std::setw(12) << "total [s]"
+      << std::setw(12) << "self [s]" << std::setw(16) << "self/evt [us]" << std::setw(8) << "self" << "\n";
+  out << std::fixed;
+  for ( std::size_t i = 0; i < NStages; ++i ) {
+    out << std::setw(12) << stageName(static_cast<Stage>(i)) << std::setw(12) << counters.calls[i]
+        << std::setprecision(3)
+        << std::setw(12) << counters.totalNs[i]*1e-9 << std::setw(12) << counters.selfNs[i]*1e-9
+        << std::setprecision(1)
+        << std::setw(16) << counters.selfNs[i]*1e-3*perEvent
+        << std::setw(7) << ( selfSum > 0 ? 100.0*counters.selfNs[i]/selfSum : 0.0 ) << "%\n";
+  }
+  out << std::defaultfloat;
+}
+
+bool xTRT::Timing::writeJSON(const std::string& fileName, const xTRT::Timing::Counters& counters,
+                             const std::size_t nEvents) {
+  nlohmann::json report;
+  report["nEvents"] = nEvents;
+  for ( std::size_t i = 0; i < NStages; ++i ) {
+    report["stages"][stageName(static_cast<Stage>(i))] = {
+      {"calls",counters.calls[i]},
+      {"totalSeconds",counters.totalNs[i]*1e-9},
+      {"selfSeconds",counters.selfNs[i]*1e-9}
+    };
+  }
+  std::ofstream out(fileName);
+  if ( not out ) {
+    XTRT_WARNING("Timing: cannot open " << fileName);
+    return false;
+  }
+  out << report.dump(2) << std::endl;
+  return static_cast<bool>(out);
+}
+
+bool xTRT::Timing::readJSON(const std::string& fileName, xTRT::Timing::Counters& counters,
+                            std::size_t& nEvents) {
+  std::ifstream in(fileName);
+  if ( not in ) {
+    XTRT_WARNING("Timing: cannot open " << fileName);
+    return false;
+  }
+  try {
+    nlohmann::json report;
+    in >> report;
+    nEvents += report.at("nEvents").get<std::size_t>();
+    const auto& stages = report.at("stages");
+    for ( std::size_t i = 0; i < NStages; ++i ) {
+      const auto itr = stages.find(stageName(static_cast<Stage>(i)));
+      if ( itr == stages.end() ) continue;
+      counters.calls[i]   += itr->at("calls").get<uint64_t>();
+      counters.totalNs[i] += std::llround(itr->at("totalSeconds").get<double>()*1e9);
+      counters.selfNs[i]  += std::llround(itr->at("selfSeconds").get<double>()*1e9);
+    }
+  }
+  catch ( const std::exception& e ) {
+    XTRT_WARNING("Timing: bad report " << fileName << ": " << e.what());
+    return false;
+  }
+  return true;
+}
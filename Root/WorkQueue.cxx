@@ -0,0 +1,118 @@
+#include <xTRTFrame/WorkQueue.h>
+#include <xTRTFrame/Utils.h>
+
+#include <SampleHandler/SampleHandler.h>
+
+#include <TFile.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace {
+  double monotonicSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+}
+
+std::vector<xTRT::WorkRange> xTRT::makeWorkRanges(const SH::SampleHandler& sh, const std::string& treeName,
+                                                  const long long rangeSize) {
+  std::vector<xTRT::WorkRange> ranges;
+  std::size_t fileIndex = 0;
+  for ( const SH::Sample* sample : sh ) {
+    for ( std::size_t i = 0; i < sample->numFiles(); ++i, ++fileIndex ) {
+      const std::string fileName = sample->fileName(i);
+      long long nEntries = -1;
+      std::unique_ptr<TFile> file(TFile::Open(fileName.c_str()));
+      if ( file && not file->IsZombie() ) {
+        TTree* tree = nullptr;
+        file->GetObject(treeName.c_str(),tree);
+        if ( tree ) nEntries = tree->GetEntries();
+        file->Close();
+      }
+      if ( nEntries < 0 || rangeSize <= 0 || nEntries <= rangeSize ) {
+        ranges.push_back({sample->name(),fileName,fileIndex,0,nEntries});
+        continue;
+      }
+      for ( long long first = 0; first < nEntries; first += rangeSize ) {
+        ranges.push_back({sample->name(),fileName,fileIndex,first,std::min(rangeSize,nEntries-first)});
+      }
+    }
+  }
+  // largest first so the small ranges fill the gaps at the end;
+  // ranges of unknown size go first
+  std::stable_sort(ranges.begin(),ranges.end(),[](const xTRT::WorkRange& a, const xTRT::WorkRange& b) {
+      const long long na = ( a.nEntries < 0 ) ? std::numeric_limits<long long>::max() : a.nEntries;
+      const long long nb = ( b.nEntries < 0 ) ? std::numeric_limits<long long>::max() : b.nEntries;
+      return na > nb;
+    });
+  return ranges;
+}
+
+xTRT::WorkQueue::WorkQueue(const std::size_t nRanges, const int nWorkers) :
+  m_shared(nullptr), m_workers(nullptr), m_bytes(0), m_nRanges(nRanges), m_nWorkers(nWorkers) {
+  m_bytes = sizeof(Shared) + std::max(nWorkers,1) * sizeof(WorkerStats);
+  void* addr = ::mmap(nullptr,m_bytes,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_ANONYMOUS,-1,0);
+  if ( addr == MAP_FAILED ) {
+    XTRT_FATAL("WorkQueue: cannot allocate shared memory");
+  }
+  m_shared  = static_cast<Shared*>(addr);
+  m_workers = reinterpret_cast<WorkerStats*>(static_cast<char*>(addr) + sizeof(Shared));
+  new (&m_shared->next) std::atomic<uint64_t>(0);
+  m_shared->start = monotonicSeconds();
+  for ( int i = 0; i < nWorkers; ++i ) {
+    m_workers[i] = WorkerStats{0,0,0,0};
+  }
+}
+
+xTRT::WorkQueue::~WorkQueue() {
+  if ( m_shared ) ::munmap(m_shared,m_bytes);
+}
+
+double xTRT::WorkQueue::elapsed() const {
+  return monotonicSeconds() - m_shared->start;
+}
+
+void xTRT::WorkQueue::recordRange(const int worker, const double busySeconds, const long long nEvents) {
+  auto& w = m_workers[worker];
+  w.busySeconds += busySeconds;
+  w.nRanges++;
+  if ( nEvents > 0 ) w.nEvents += nEvents;
+}
+
+void xTRT::WorkQueue::recordFinished(const int worker) {
+  m_workers[worker].finishSeconds = elapsed();
+}
+
+void xTRT::WorkQueue::printSummary() const {
+  double firstFinish = -1, lastFinish = 0, busy = 0;
+  for ( int i = 0; i < m_nWorkers; ++i ) {
+    const auto& w = m_workers[i];
+    if ( firstFinish < 0 || w.finishSeconds < firstFinish ) firstFinish = w.finishSeconds;
+    lastFinish = std::max(lastFinish,w.finishSeconds);
+    busy += w.busySeconds;
+  }
+  std::cout << "Scheduler summary (" << m_nRanges << " ranges, " << m_nWorkers << " workers)" << std::endl;
+  std::cout << std::setw(8) << "worker" << std::setw(8) << "ranges" << std::setw(12) << "events"
+            << std::setw(12) << "busy [s]" << std::setw(12) << "done [s]" << std::setw(8) << "util" << std::endl;
+  for ( int i = 0; i < m_nWorkers; ++i ) {
+    const auto& w = m_workers[i];
+    std::cout << std::setw(8) << i << std::setw(8) << w.nRanges << std::setw(12) << w.nEvents
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << w.busySeconds << std::setw(12) << w.finishSeconds
+              << std::setw(7) << ( lastFinish > 0 ? 100*w.busySeconds/lastFinish : 0 ) << "%"
+              << std::defaultfloat << std::endl;
+  }
+  std::cout << std::fixed << std::setprecision(1)
+            << "Wall time: " << lastFinish << " s, tail latency (first to last worker done): "
+            << ( lastFinish - std::max(firstFinish,0.0) ) << " s, overall utilization: "
+            << ( lastFinish > 0 ? 100*busy/(lastFinish*m_nWorkers) : 0 ) << "%"
+            << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,78 @@
+#include <xTRTFrame/HitKernels.h>
+#include <xTRTFrame/Externals/CLI11.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Benchmark of the track length in straw kernel: random hits are
+// grouped in "tracks" (like xTRT::HitBlock) and L is computed with
+// both the scalar reference and the dispatched (SIMD) version.
+
+int main(int argc, char** argv) {
+  CLI::App app("xTRTFrame hit kernel benchmark");
+
+  std::size_t nTracks = 200000;
+  app.add_option("-t,--tracks",nTracks,"Number of tracks");
+  std::size_t nHits = 35;
+  app.add_option("-n,--hits",nHits,"Number of hits per track");
+  float endcapFraction = 0.5;
+  app.add_option("-e,--endcap-fraction",endcapFraction,"Fraction of end cap hits");
+
+  CLI11_PARSE(app, argc, argv);
+
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> rDist(0.0,2.0);
+  std::uniform_real_distribution<float> phiDist(-M_PI,M_PI);
+  std::uniform_real_distribution<float> thetaDist(0.1,M_PI-0.1);
+  std::uniform_real_distribution<float> flat(0.0,1.0);
+
+  const std::size_t nTotal = nTracks*nHits;
+  std::vector<float> rTrkWire(nTotal), localPhi(nTotal), Lscalar(nTotal), Lsimd(nTotal);
+  std::vector<int>   bec(nTotal);
+  std::vector<float> theta(nTracks), phi(nTracks);
+  for ( std::size_t i = 0; i < nTotal; ++i ) {
+    rTrkWire[i] = rDist(gen);
+    localPhi[i] = phiDist(gen);
+    const int side = ( flat(gen) < 0.5 ) ? -1 : 1;
+    bec[i] = ( flat(gen) < endcapFraction ) ? 2*side : side;
+  }
+  for ( std::size_t i = 0; i < nTracks; ++i ) {
+    theta[i] = thetaDist(gen);
+    phi[i]   = phiDist(gen);
+  }
+
+  auto run = [&](decltype(&xTRT::trackLengthInStraw) kernel, std::vector<float>& L) {
+    auto start = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < nTracks; ++i ) {
+      const std::size_t off = i*nHits;
+      kernel(rTrkWire.data()+off,localPhi.data()+off,bec.data()+off,nHits,theta[i],phi[i],L.data()+off);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop-start).count();
+  };
+
+  // warm up once, then time
+  run(xTRT::trackLengthInStrawScalar,Lscalar);
+  run(xTRT::trackLengthInStraw,Lsimd);
+  const double tScalar = run(xTRT::trackLengthInStrawScalar,Lscalar);
+  const double tSimd   = run(xTRT::trackLengthInStraw,Lsimd);
+
+  double maxRelDiff = 0;
+  for ( std::size_t i = 0; i < nTotal; ++i ) {
+    maxRelDiff = std::max(maxRelDiff,(double)std::fabs(Lsimd[i]-Lscalar[i])/std::fabs(Lscalar[i]));
+  }
+
+  std::cout << "hits:                " << nTotal << " (" << nTracks << " tracks)" << std::endl;
+  std::cout << "scalar:              " << nTotal/tScalar << " hits/s" << std::endl;
+  std::cout << std::left << std::setw(21) << (std::string(xTRT::trackLengthInStrawImpl())+":")
+            << nTotal/tSimd << " hits/s (x" << tScalar/tSimd << ")" << std::endl;
+  std::cout << "max relative diff:   " << maxRelDiff << std::endl;
+
+  return 0;
+}
@@ -9,6 +9,10 @@
 #ifndef xTRTFrame_Accessors_h
 #define xTRTFrame_Accessors_h
 
+// C++
+#include <string>
+#include <unordered_map>
+
 // ATLAS
 #include <AthContainers/AuxElement.h>
 #include <xAODTracking/TrackStateValidationContainer.h>
@@ -35,6 +39,17 @@ namespace xTRT {
     {"numberOfNextToInnermostPixelLayerHits"};
     const SG::AuxElement::ConstAccessor<unsigned char> numberOfPixelHits {"numberOfPixelHits"};
     const SG::AuxElement::ConstAccessor<unsigned char> numberOfSCTHits   {"numberOfSCTHits"};
+    const SG::AuxElement::ConstAccessor<unsigned char> numberOfTRTHighThresholdHits
+    {"numberOfTRTHighThresholdHits"};
+    const SG::AuxElement::ConstAccessor<unsigned char> numberOfTRTHighThresholdOutliers
+    {"numberOfTRTHighThresholdOutliers"};
+    const SG::AuxElement::ConstAccessor<unsigned char> numberOfPixelHoles       {"numberOfPixelHoles"};
+    const SG::AuxElement::ConstAccessor<unsigned char> numberOfSCTHoles         {"numberOfSCTHoles"};
+    const SG::AuxElement::ConstAccessor<unsigned char> numberOfPixelSharedHits  {"numberOfPixelSharedHits"};
+    const SG::AuxElement::ConstAccessor<unsigned char> numberOfSCTSharedHits    {"numberOfSCTSharedHits"};
+
+    const SG::AuxElement::ConstAccessor<float> theta  {"theta"};
+    const SG::AuxElement::ConstAccessor<float> qOverP {"qOverP"};
 
     const SG::AuxElement::ConstAccessor<float> numberDoF  {"numberDoF"};
     const SG::AuxElement::ConstAccessor<float> chiSquared {"chiSquared"};
@@ -52,6 +67,7 @@ namespace xTRT {
     const SG::AuxElement::ConstAccessor<char>  gasType     {"gasType"};
     const SG::AuxElement::ConstAccessor<int>   bec         {"bec"};
     const SG::AuxElement::ConstAccessor<int>   layer       {"layer"};
+    const SG::AuxElement::ConstAccessor<int>   phi_module  {"phi_module"};
     const SG::AuxElement::ConstAccessor<int>   strawlayer  {"strawlayer"};
     const SG::AuxElement::ConstAccessor<int>   strawnumber {"strawnumber"};
     const SG::AuxElement::ConstAccessor<float> drifttime   {"drifttime"};
@@ -69,6 +85,63 @@ namespace xTRT {
     const SG::AuxElement::ConstAccessor<float> rTrkWire   {"rTrkWire"};
 
   }
+
+  /// get the ConstAccessor for an aux variable by name
+  /**
+   *  Accessors are kept in one hashed name to accessor registry per
+   *  type; the first call with a name creates (and registers the
+   *  auxid of) the accessor, later calls are a hash lookup. The
+   *  returned reference stays valid for the whole job. The registry
+   *  is not locked: the EventLoop worker runs the algorithm in one
+   *  thread.
+   *
+   *  Per object code should resolve the name once with an
+   *  xTRT::AuxHandle instead of looking it up per call.
+   *
+   *  @param name the aux variable name
+   */
+  template <class T>
+  const SG::AuxElement::ConstAccessor<T>& accessor(const std::string& name);
+
+  /** @class xTRT::AuxHandle
+   *  @brief An aux variable name resolved once to its ConstAccessor
+   *
+   *  The name is looked up in the xTRT::accessor registry when the
+   *  handle is built; reading through it (see
+   *  xTRT::Algorithm::retrieve) does no lookups at all. Keep the
+   *  handle as a member or a local outside the object loop:
+   *
+   *  @code{.cpp}
+   *  const xTRT::AuxHandle<float> eProbHT("eProbabilityHT");
+   *  for ( auto track : *tracks ) { float pHT = retrieve(track,eProbHT); ... }
+   *  @endcode
+   */
+  template <class T>
+  class AuxHandle {
+  private:
+    const SG::AuxElement::ConstAccessor<T>* m_acc;
+    std::string                             m_name;
+
+  public:
+    /// resolve the aux variable name
+    explicit AuxHandle(const std::string& name) : m_acc(&xTRT::accessor<T>(name)), m_name(name) {}
+
+    /// the accessor
+    const SG::AuxElement::ConstAccessor<T>& accessor() const { return *m_acc; }
+    /// the aux variable name
+    const std::string& name() const { return m_name; }
+  };
+
+}
+
+template <class T>
+inline const SG::AuxElement::ConstAccessor<T>& xTRT::accessor(const std::string& name) {
+  static std::unordered_map<std::string,SG::AuxElement::ConstAccessor<T>> registry;
+  auto itr = registry.find(name);
+  if ( itr == registry.end() ) {
+    itr = registry.emplace(name,SG::AuxElement::ConstAccessor<T>(name)).first;
+  }
+  return itr->second;
 }
 
 #endif
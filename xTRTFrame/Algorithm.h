@@ -21,6 +21,8 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <array>
 #include <functional>
 
 // ATLAS
@@ -30,26 +32,120 @@
 #include <xTRTFrame/Utils.h>
 #include <xTRTFrame/Accessors.h>
 #include <xTRTFrame/HitSummary.h>
+#include <xTRTFrame/HitBlock.h>
+#include <xTRTFrame/HistHandle.h>
+#include <xTRTFrame/FillBuffer.h>
+#include <xTRTFrame/StrawAccumulator.h>
+#include <xTRTFrame/HitNtupleWriter.h>
+#include <xTRTFrame/HitStore.h>
+#include <xTRTFrame/TrackSummary.h>
 #include <xTRTFrame/Config.h>
 #include <xTRTFrame/Helpers.h>
+#include <xTRTFrame/Timing.h>
+#include <xTRTFrame/CutFlow.h>
+#include <xTRTFrame/SelectionEngine.h>
+#include <xTRTFrame/CompiledTrackSelection.h>
+#include <xTRTFrame/BatchSelection.h>
 
 // ROOT
 #include <TTree.h>
 
 namespace xTRT {
 
+  /// an object and the summary of its track (nullptr if none) as seen by a selection
+  template <class T>
+  struct Candidate {
+    const T*                  object;
+    const xTRT::TrackSummary* track;
+  };
+
   class Algorithm : public EL::Algorithm {
 
   private:
     xTRT::Config m_config;
 
     std::map<std::string,TObject*> m_objStore; //!
+    std::vector<std::unique_ptr<xTRT::FillBuffer>> m_fillBuffers; //!
+    std::unique_ptr<xTRT::StrawAccumulator>        m_strawAccumulator; //!
+    std::vector<std::unique_ptr<xTRT::HitNtupleWriter>> m_hitNtuples; //!
+    std::vector<std::unique_ptr<xTRT::HitStoreWriter>>  m_hitStores;  //!
+    std::vector<std::unique_ptr<xTRT::CutFlow>>         m_cutFlows;   //!
+
+    // cut flows of the built-in selections (null unless config says CutFlow)
+    xTRT::CutFlow* m_trackCutFlow{nullptr};    //!
+    xTRT::CutFlow* m_electronCutFlow{nullptr}; //!
+    xTRT::CutFlow* m_muonCutFlow{nullptr};     //!
+
+    // adaptive cut order selections (null unless config says Selection.Adaptive and no CutFlow)
+    std::unique_ptr<xTRT::SelectionEngine<xTRT::Candidate<xAOD::Electron>>> m_electronEngine; //!
+    std::unique_ptr<xTRT::SelectionEngine<xTRT::Candidate<xAOD::Muon>>>     m_muonEngine;     //!
+
+    // the Tracks.* cuts compiled in initialize() and the per event decisions
+    xTRT::CompiledTrackSelection          m_trackSelection;      //!
+    xTRT::ColumnSelection<xAOD::Electron> m_electronKinematics;  //!
+    xTRT::ColumnSelection<xAOD::Muon>     m_muonKinematics;      //!
+    xTRT::BitMask                         m_trackMask;           //!
+    xTRT::BitMask                         m_electronMask;        //!
+    xTRT::BitMask                         m_muonMask;            //!
 
     int m_eventCounter;                 //!
     const xAOD::EventInfo* m_eventInfo; //!
     xAOD::TEvent* m_event;              //!
     xAOD::TStore* m_store;              //!
 
+    // per event values derived from the EventInfo (set in execute(),
+    // averageMu and passGRL on first use since they call tools)
+    bool  m_isMC{false};       //!
+    float m_eventWeight{1.0};  //!
+    float m_averageMu{0.0};    //!
+    bool  m_averageMuCached{false}; //!
+    mutable bool m_passGRL{true};         //!
+    mutable bool m_passGRLCached{false};  //!
+    mutable std::size_t m_evtInfoLookupsAvoided{0}; //!
+
+    // per event cache of container pointers (reset in execute())
+    const xAOD::TrackParticleContainer* m_trackContainer{nullptr};    //!
+    const xAOD::ElectronContainer*      m_electronContainer{nullptr}; //!
+    const xAOD::MuonContainer*          m_muonContainer{nullptr};     //!
+    std::array<const xAOD::TrackParticleContainer*,2> m_selectedTracks{{nullptr,nullptr}};    //!
+    std::array<const xAOD::ElectronContainer*,2>      m_selectedElectrons{{nullptr,nullptr}}; //!
+    std::array<const xAOD::MuonContainer*,2>          m_selectedMuons{{nullptr,nullptr}};     //!
+
+    // per event track summaries, indexed like InDetTrackParticles
+    std::vector<xTRT::TrackSummary> m_trackSummaries;       //!
+    bool                            m_trackSummariesFilled{false}; //!
+
+    // aux columns feeding fillHitBlock (bound once per container per event)
+    xTRT::HitColumns m_hitColumns; //!
+
+    // chain groups resolved once (in enableTriggerTools() or on first use), by chain id
+    mutable std::vector<const Trig::ChainGroup*>        m_chainGroups; //!
+    mutable std::vector<std::string>                    m_chainNames;  //!
+    mutable std::unordered_map<std::string,std::size_t> m_chainIds;    //!
+    std::vector<std::size_t> m_electronTrigIds; //!
+    std::vector<std::size_t> m_muonTrigIds;     //!
+
+    // per event trigger match results, [object index * n chains + i chain]
+    // (-1: not checked yet, 0: no match, 1: match)
+    std::vector<int8_t> m_electronMatchCache; //!
+    std::vector<int8_t> m_muonMatchCache;     //!
+    std::size_t         m_trigMatchesAvoided{0}; //!
+
+    // per event InDetTrackSelectionTool decisions by track: bit c of the
+    // low nibble is set once IDTSCut c was evaluated, bit c+4 if it passed;
+    // indexed by track index for InDetTrackParticles, by pointer otherwise
+    std::vector<uint8_t> m_idtsDecisions; //!
+    std::unordered_map<const xAOD::TrackParticle*,uint8_t> m_idtsCache; //!
+    std::size_t m_idtsCacheHits{0};  //!
+    std::size_t m_idtsToolCalls{0};  //!
+
+    // input branches read during the first Cache.AutoEvents events
+    std::vector<std::string> m_cacheAutoBranches; //!
+    bool                     m_cacheAutoDone{false}; //!
+
+    // times the derived execute (from the end of execute to postExecute)
+    std::unique_ptr<xTRT::Timing::StageTimer> m_userTimer; //!
+
   private:
     asg::AnaToolHandle<IGoodRunsListSelectionTool>
     m_GRLToolHandle{"GoodRunsListSelectionTool/GRLTool",this}; //!
@@ -73,6 +169,37 @@ namespace xTRT {
 
   protected:
     std::string m_outputName{"xTRTFrameOutput"};
+    std::string m_jobOutputDir;
+
+  private:
+    /// forget everything cached for the previous event
+    void clearEventCache();
+    /// retrieve the EventInfo and compute the cheap values derived from it
+    EL::StatusCode cacheEventInfo();
+    /// the (PRW corrected for data) average mu of the current event
+    float computeAverageMu();
+    /// the GRL decision of the current event
+    bool computePassGRL() const;
+    /// fill the summary record of every InDetTrackParticle in one pass
+    void fillTrackSummaries();
+    /// id of a trigger chain in the chain group table (resolved on first use)
+    std::size_t chainId(const std::string& trigName) const;
+    /// trigger match of a particle against a list of chains, cached per event
+    bool trigMatched(const xAOD::IParticle* particle, const SG::AuxVectorData* rawContainer,
+                     const std::size_t rawSize, const std::vector<std::size_t>& ids,
+                     std::vector<int8_t>& cache);
+    /// InDetTrackSelectionTool decision for a track, cached per event
+    bool idtsAccept(const xAOD::TrackParticle* trk, const xAOD::Vertex* vtx, const xTRT::IDTSCut cut);
+    /// look up the drift circle aux columns used by fillHitBlock
+    void bindDriftCircleColumns(const xAOD::TrackMeasurementValidation* driftCircle);
+    /// look up the MSOS aux columns used by fillHitBlock
+    void bindMsosColumns(const xAOD::TrackStateValidation* msos);
+    /// build the adaptive electron and muon selections from the config
+    void setupSelectionEngines();
+    /// restrict the input TTreeCache to the configured (and learned) branches
+    void configureInputCache();
+    /// collect the input branches read so far and restrict the cache to them
+    void learnInputCache();
 
   public:
     Algorithm();
@@ -90,33 +217,123 @@ namespace xTRT {
     /// sets up the xTRT::Config class given a config file
     void feedConfig(const std::string fileName, bool print_conf = false, bool mcMode = false);
 
+    /// override a config file option (call before feedConfig)
+    void overrideConfig(const std::string& name, const std::string& value);
+
     /// Sets the treeOutput name for the EL::NTupleSvc
     void setTreeOutputName(const std::string name);
 
+    /// Sets the directory for the job's own output files (hit stores, JSON reports)
+    /**
+     *  xTRT::Runner sets this to the submit directory (or to the
+     *  range directory of each --jobs range), so that jobs never
+     *  write to the same file. If not set, files go to the working
+     *  directory.
+     */
+    void setJobOutputDir(const std::string& dir);
+
+    /// path of a job output file: relative names are put in the job output directory
+    std::string jobOutputPath(const std::string& fileName) const;
+
+    /// name of the stage timing JSON file written by finalize (empty if timing is off)
+    std::string timingReport() const;
+    /// name of the cut flow JSON file written by histFinalize (empty if cut flows are off)
+    std::string cutFlowReport() const;
+
   protected:
     /// Creates a ROOT object to be stored.
     /**
      *  This allows easy creation by just calling the constructor of a
      *  ROOT object (such as a TH1F or TProfile). The name given to the
      *  object constructor will be used to manipulate the pointer to
-     *  the copy which is stored.
+     *  the copy which is stored. The returned handle points directly
+     *  to that copy; filling through it is the fast path (no lookup).
      *
      *  @param obj the ROOT output object (THx, TProfile, etc.)
      */
     template <typename T>
-    void create(const T obj);
+    xTRT::HistHandle<T> create(const T obj);
 
     /// Get access to a ROOT object which will be stored
     /**
      *  Using the name of the TObject staged for storage with the
      *  Algorithm::create function, retrieve and manipulate the object, used
-     *  for e.g. filling a histogram.
+     *  for e.g. filling a histogram. This is a name lookup, prefer
+     *  keeping the xTRT::HistHandle returned by create in loops.
      *
      *  @param name the name of the created ROOT object to update/modify.
      */
     template <typename T>
     T* grab(const std::string& name);
 
+    /// Creates a 1D histogram to be stored and filled through a buffer
+    /**
+     *  Same as Algorithm::create, but the returned xTRT::FillBuffer
+     *  batches the fills (flushed when full and at the end of every
+     *  event in postExecute). The buffer is owned by the algorithm.
+     *
+     *  @param obj the ROOT histogram (TH1F, TH1D, ...)
+     *  @param capacity number of fills staged before a flush
+     *  @param prebinned use the fixed bin width fast path if possible
+     */
+    template <typename T>
+    xTRT::FillBuffer* createBuffered(const T obj, const std::size_t capacity = 4096,
+                                     const bool prebinned = true);
+
+    /// Get a fill buffer for a histogram already made with Algorithm::create
+    /**
+     *  @param hist the histogram (e.g. from Algorithm::grab or a xTRT::HistHandle)
+     *  @param capacity number of fills staged before a flush
+     *  @param prebinned use the fixed bin width fast path if possible
+     */
+    xTRT::FillBuffer* fillBuffer(TH1* hist, const std::size_t capacity = 4096,
+                                 const bool prebinned = true);
+
+    /// flush all fill buffers (done automatically in postExecute)
+    void flushFillBuffers();
+
+    /// Get the per straw accumulator (created on first call)
+    /**
+     *  Hits added to the accumulator (see xTRT::StrawAccumulator::add)
+     *  are summed per straw over the whole job. If the accumulator
+     *  was used it is written to the tree output as the
+     *  "StrawAccumulator" tree (one entry per straw with hits) in
+     *  finalize.
+     */
+    xTRT::StrawAccumulator* strawAccumulator();
+
+    /// Creates a tree in the tree output and a xTRT::HitNtupleWriter filling it
+    /**
+     *  The writer is owned by the algorithm. Call it from
+     *  initialize (the output file must exist).
+     *
+     *  @param treeName the name of the output tree
+     */
+    xTRT::HitNtupleWriter* createHitNtuple(const std::string& treeName);
+
+    /// Creates a xTRT::HitStoreWriter exporting to a memory mappable hit store
+    /**
+     *  The writer is owned by the algorithm and the file is written
+     *  when the store is closed in finalize (see xTRT::HitStoreReader
+     *  for reading it back).
+     *
+     *  @param fileName the output file name (relative names are put in
+     *  the job output directory, see xTRT::Algorithm::jobOutputPath)
+     */
+    xTRT::HitStoreWriter* createHitStore(const std::string& fileName);
+
+    /// Creates a xTRT::CutFlow for a selection
+    /**
+     *  The cut flow is owned by the algorithm; at histFinalize its
+     *  histogram (CutFlow_<name>) is saved, its counters and
+     *  suggested cut order are logged and written to the
+     *  CutFlow.JSON file together with all other cut flows.
+     *
+     *  @param name the name of the cut flow
+     *  @param countCycles count cycles spent per cut (for the suggested order)
+     */
+    xTRT::CutFlow* createCutFlow(const std::string& name, const bool countCycles = false);
+
     /// const pointer access to the configuration class
     const xTRT::Config* config() const;
 
@@ -131,17 +348,33 @@ namespace xTRT {
     EL::StatusCode enableTriggerTools();
 
   public:
-    /// checks if a track passes cuts defined in the config
-    static bool passTrackSelection(const xAOD::TrackParticle* track, const xTRT::Config* conf);
+    /// checks if a track passes cuts defined in the config (counted in cutflow if given)
+    static bool passTrackSelection(const xAOD::TrackParticle* track, const xTRT::Config* conf,
+                                   xTRT::CutFlow* cutflow = nullptr);
+    /// checks if a track (from its summary record) passes cuts defined in the config
+    static bool passTrackSelection(const xTRT::TrackSummary& trkSummary, const xTRT::Config* conf,
+                                   xTRT::CutFlow* cutflow = nullptr);
     /// checks if an electron passes cuts defined in the config
-    static bool passElectronSelection(const xAOD::Electron* electron, const xTRT::Config* conf);
+    static bool passElectronSelection(const xAOD::Electron* electron, const xTRT::Config* conf,
+                                      xTRT::CutFlow* cutflow = nullptr);
+    /// checks if an electron passes cuts defined in the config, given its track summary (nullptr if no track)
+    static bool passElectronSelection(const xAOD::Electron* electron, const xTRT::TrackSummary* trkSummary,
+                                      const xTRT::Config* conf, xTRT::CutFlow* cutflow = nullptr);
     /// checks if a muon passes cuts defined in the config
-    static bool passMuonSelection(const xAOD::Muon* muon, const xTRT::Config* conf);
+    static bool passMuonSelection(const xAOD::Muon* muon, const xTRT::Config* conf,
+                                  xTRT::CutFlow* cutflow = nullptr);
+    /// checks if a muon passes cuts defined in the config, given its track summary (nullptr if no track)
+    static bool passMuonSelection(const xAOD::Muon* muon, const xTRT::TrackSummary* trkSummary,
+                                  const xTRT::Config* conf, xTRT::CutFlow* cutflow = nullptr);
 
   protected:
 
     /** \addtogroup ContainerGetters Container Getters
      *  \brief functions to easily grab (and define) different xAOD containers.
+     *
+     *  The raw and selected container getters are cached for the
+     *  current event: only the first call per event touches the
+     *  store, later calls return the same pointer.
      *  @{
      */
 
@@ -152,35 +385,63 @@ namespace xTRT {
     /// returns the raw electron container (no selection applied)
     const xAOD::MuonContainer*          muonContainer();
 
-    /// use raw container to form deep copy containing only selected objects
+    /// use raw container to form a container holding only selected objects
     /**
      *  The class C must be a container of type T. This will create
-     *  and return a deep copy of the raw container with name contName
-     *  after applying the selection defined in the selector function.
+     *  and return a container with name contName holding the objects
+     *  of the raw container which pass the selection defined in the
+     *  selector function. By default the new container is a view
+     *  (pointers into the raw container, no copying); a deep copy is
+     *  only needed if you want to decorate the selected objects. If a
+     *  container named contName was already built this event it is
+     *  returned as is.
      *
      *  @param raw the raw container
      *  @param selector the (static) function which applies the selection
-     *  @param contName the name of the new deep copy container
+     *  @param contName the name of the new container
+     *  @param mode build a view (default) or a deep copy
      */
     template <class C, class T>
     const C* selectedContainer(const C* raw,
                                std::function<bool(const T*,const xTRT::Config*)> selector,
-                               const std::string& contName);
+                               const std::string& contName,
+                               const xTRT::ContainerMode mode = xTRT::ContainerMode::VIEW);
+
+    /// use raw container and a mask of decisions to form a container holding only selected objects
+    /**
+     *  Same as the selector version, for decisions already made for
+     *  the whole container at once (bit i of the mask is object i of
+     *  raw), e.g. by xTRT::ColumnSelection or xTRT::selectMask.
+     *
+     *  @param raw the raw container
+     *  @param mask the decisions, indexed like raw
+     *  @param contName the name of the new container
+     *  @param mode build a view (default) or a deep copy
+     */
+    template <class C>
+    const C* selectedContainer(const C* raw, const xTRT::BitMask& mask,
+                               const std::string& contName,
+                               const xTRT::ContainerMode mode = xTRT::ContainerMode::VIEW);
 
     /// applies selectedContainer on tracks using config file settings
-    const xAOD::TrackParticleContainer* selectedTracks();
+    const xAOD::TrackParticleContainer* selectedTracks(const xTRT::ContainerMode mode = xTRT::ContainerMode::VIEW);
     /// applies selectedContainer on electrons using config file settings
-    const xAOD::ElectronContainer*      selectedElectrons();
+    const xAOD::ElectronContainer*      selectedElectrons(const xTRT::ContainerMode mode = xTRT::ContainerMode::VIEW);
     /// applies selectedContainer on muons using config file settings
-    const xAOD::MuonContainer*          selectedMuons();
+    const xAOD::MuonContainer*          selectedMuons(const xTRT::ContainerMode mode = xTRT::ContainerMode::VIEW);
 
     /// get a new container of TrackParticles, Electrons, or Muons passing some IDTS cuts
     /**
-     *  This will create and return a deep copy of selected objects
+     *  This will create and return a container of selected objects
      *   living in a raw container after applying the set of cuts fed
      *   to this function. The cuts can be any combination of the four
      *   InDetTrackSelectionTool levels, defined in the enum
-     *   xTRT::IDTSCut.
+     *   xTRT::IDTSCut. By default the container is a view into the
+     *   raw container; ask for xTRT::ContainerMode::DEEPCOPY if you
+     *   need to decorate the selected objects. The tool decisions are
+     *   cached per event and track, so other selections in the same
+     *   event (also of electrons or muons sharing the track) don't
+     *   call the tools again.
      *
      *  example:
      *
@@ -189,15 +450,29 @@ namespace xTRT {
      *
      *  @param raw the raw container
      *  @param cuts the list (in braced-init-list form)
-     *  @param contName the name of the new deep copy container
+     *  @param contName the name of the new container
+     *  @param mode build a view (default) or a deep copy
      */
     template <class T>
     const DataVector<T>* selectedFromIDTScuts(const DataVector<T>* raw,
                                               const std::initializer_list<xTRT::IDTSCut> cuts,
-                                              const std::string& contName);
+                                              const std::string& contName,
+                                              const xTRT::ContainerMode mode = xTRT::ContainerMode::VIEW);
 
     /** @}*/
 
+  private:
+    /// true for the framework's fixed selection names (xTRT_Good*), which are built once per event
+    static bool reusableContainer(const std::string& contName);
+    /// build a view or deep copy container from the objects passing a selection
+    template <class C, class T>
+    const C* buildContainer(const C* raw, std::function<bool(const T*)> passes,
+                            const std::string& contName, const xTRT::ContainerMode mode);
+    /// build a view or deep copy container from the objects set in mask
+    template <class C, class T>
+    const C* buildContainer(const C* raw, const xTRT::BitMask& mask,
+                            const std::string& contName, const xTRT::ContainerMode mode);
+
   public:
     /// retrieves the TruthParticle associated with the input track particle
     static const xAOD::TruthParticle* getTruth(const xAOD::TrackParticle* track);
@@ -213,6 +488,27 @@ namespace xTRT {
     static const xAOD::TrackParticle* getTrack(const xAOD::TrackParticle* track);
 
   protected:
+    /// get the summary record of a track
+    /**
+     *  For tracks in InDetTrackParticles the record comes from a per
+     *  event cache filled in one pass over the container the first
+     *  time it is needed; other tracks (e.g. GSF tracks) get a record
+     *  filled on the spot with xTRT::Algorithm::getTrackSummary.
+     *
+     *  @param track the track particle
+     */
+    xTRT::TrackSummary trackSummary(const xAOD::TrackParticle* track);
+
+  protected:
+    /** \addtogroup EventGetters Event Getters
+     *  \brief per event information
+     *
+     *  The EventInfo and the values derived from it are retrieved
+     *  once per event in xTRT::Algorithm::execute(); these functions
+     *  only return the cached values.
+     *  @{
+     */
+
     /// check if the sample is MC
     bool isMC() const;
     /// check if the sample is Data (convenience function, opposite of isMC())
@@ -233,6 +529,8 @@ namespace xTRT {
     /// get const pointer to the current event's xAOD::EventInfo
     const xAOD::EventInfo* eventInfo() const;
 
+    /** @}*/
+
   protected:
     /// check for a nullptr and print a debug message
     /**
@@ -276,6 +574,9 @@ namespace xTRT {
      *  @{
      */
 
+    /// fill a summary record (hit counts and kinematics) for a single track
+    static xTRT::TrackSummary getTrackSummary(const xAOD::TrackParticle* track);
+
     /// return the number of TRT hits on the track (all)
     static int nTRT(const xAOD::TrackParticle* track);
     /// return the number of TRT prec+tube (non outlier)
@@ -329,6 +630,21 @@ namespace xTRT {
     static xTRT::HitSummary getHitSummary(const xAOD::TrackParticle* track,
                                           const xAOD::TrackStateValidation* msos,
                                           const xAOD::TrackMeasurementValidation* driftCircle);
+
+    /// fill a xTRT::HitBlock with all TRT hits on a track
+    /**
+     *  This is the batch version of xTRT::Algorithm::getHitSummary:
+     *  every TRT surface measurement (msos) of the track with a valid
+     *  drift circle link is added to the block (which is cleared
+     *  first). The aux variables are looked up once per container
+     *  instead of once per hit, so this should be preferred in hit
+     *  loops. Missing variables are reported once and read as 0.
+     *
+     *  @param track the track particle
+     *  @param block the (reusable) block to fill
+     *  @return the number of hits in the block
+     */
+    std::size_t fillHitBlock(const xAOD::TrackParticle* track, xTRT::HitBlock& block);
     /** @}*/
 
   public:
@@ -341,7 +657,9 @@ namespace xTRT {
     /// grab aux data by using ConstAccessor and some object
     /**
      *  Using a ConstAccessor, look to see if the object has the
-     *  auxdata and then return it.
+     *  auxdata and then return it. A missing variable returns 0 and
+     *  is reported once per input file. For loops over a whole
+     *  container use xTRT::auxSpan instead.
      *
      *  @param acc the const accessor object
      *  @param xobj the xAOD object to grab the auxdata from
@@ -352,17 +670,31 @@ namespace xTRT {
 
     /// grab aux data from an xAOD object based on name
     /**
-     *  This function will create a ConstAccessor to retrieve some aux
-     *  data from the object. This is differen from the get function
-     *  in that you must supply the return type, where with get the
-     *  return type is deduced by the compiler from the already
-     *  declared ConstAccessor.
+     *  This function will find the ConstAccessor (see xTRT::accessor)
+     *  to retrieve some aux data from the object. This is differen
+     *  from the get function in that you must supply the return
+     *  type, where with get the return type is deduced by the
+     *  compiler from the already declared ConstAccessor.
+     *
+     *  Every call looks the name up in the accessor registry; per
+     *  object code should use the xTRT::AuxHandle overload.
      *
      *  @param xobj the xAOD object to retrieve the auxdata from
      *  @param adn the aux data variable name
      */
     template <typename T1, typename T2 = SG::AuxElement>
-    static T1 retrieve(const T2* xobj, const std::string adn);
+    static T1 retrieve(const T2* xobj, const std::string& adn);
+
+    /// grab aux data from an xAOD object through a resolved xTRT::AuxHandle
+    /**
+     *  Same as retrieve by name, without the name lookup (the return
+     *  type is deduced from the handle).
+     *
+     *  @param xobj the xAOD object to retrieve the auxdata from
+     *  @param handle the aux variable handle
+     */
+    template <typename T1, typename T2>
+    static T1 retrieve(const T2* xobj, const xTRT::AuxHandle<T1>& handle);
 
     /** @}*/
 
@@ -10,6 +10,8 @@
 #include <xAODTracking/TrackParticle.h>
 #include <xAODEventInfo/EventInfo.h>
 #include <xAODCore/ShallowCopy.h>
+#include <xAODCore/AuxContainerBase.h>
+#include <AthContainers/ConstDataVector.h>
 #include <xAODMuon/MuonContainer.h>
 #include <xAODMuon/MuonAuxContainer.h>
 #include <xAODEgamma/EgammaxAODHelpers.h>
@@ -0,0 +1,94 @@
+/** @file  AuxColumn.h
+ *  @brief xTRT::AuxSpan class header and container level aux helpers
+ *  @class xTRT::AuxSpan
+ *  @brief Read only view of one aux variable of a whole container
+ *
+ *  The aux store keeps each variable of a container in one
+ *  contiguous array. Instead of asking every element whether a
+ *  variable is available, xTRT::auxSpan checks the container once
+ *  and hands back a pointer/size pair over the column, so hot loops
+ *  read contiguous memory by element index. A span over a missing
+ *  variable is empty and xTRT::AuxSpan::value returns 0.
+ *
+ *  Missing variables are reported once per input file (see
+ *  xTRT::firstMissingAux), not once per object.
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_AuxColumn_h
+#define xTRTFrame_AuxColumn_h
+
+// C++
+#include <cstddef>
+#include <string>
+
+// ATLAS
+#include <AthContainers/AuxElement.h>
+#include <AthContainers/AuxVectorData.h>
+
+// xTRTFrame
+#include <xTRTFrame/Utils.h>
+
+namespace xTRT {
+
+  template <class T>
+  class AuxSpan {
+
+  private:
+    const T*    m_data{nullptr};
+    std::size_t m_size{0};
+
+  public:
+    AuxSpan() = default;
+    AuxSpan(const T* data, const std::size_t size) : m_data(data), m_size(size) {}
+
+    /// true if the column exists in the container
+    bool        available()                   const { return m_data != nullptr; }
+    /// pointer to the first element of the column
+    const T*    data()                        const { return m_data; }
+    /// number of entries (size of the container)
+    std::size_t size()                        const { return m_size; }
+    /// true if there is nothing to read
+    bool        empty()                       const { return m_size == 0; }
+    const T*    begin()                       const { return m_data; }
+    const T*    end()                         const { return m_data + m_size; }
+    /// unchecked access
+    const T&    operator[](const std::size_t i) const { return m_data[i]; }
+    /// value at index i, or 0 if the column is not available
+    T           value(const std::size_t i)    const { return ( m_data ? m_data[i] : T() ); }
+
+  };
+
+  /// true the first time a missing aux variable is seen in the current file
+  /**
+   *  Used to print one warning per variable and input file instead
+   *  of one per object. xTRT::Algorithm::changeInput resets the
+   *  record with xTRT::clearMissingAux.
+   *
+   *  @param name the aux variable name
+   */
+  bool firstMissingAux(const std::string& name);
+
+  /// forget which missing aux variables were already reported
+  void clearMissingAux();
+
+  /// bind an accessor to a container and get a span over its column
+  /**
+   *  Availability is checked once for the whole container. If the
+   *  variable is missing a warning is printed (once per file) and an
+   *  empty span is returned.
+   *
+   *  @param acc the const accessor of the variable
+   *  @param container the container (e.g. elem->container())
+   *  @param name the aux variable name (for the warning)
+   */
+  template <class T>
+  AuxSpan<T> auxSpan(const SG::AuxElement::ConstAccessor<T>& acc,
+                     const SG::AuxVectorData* container, const std::string& name);
+
+}
+
+#include "AuxColumn.icc"
+
+#endif
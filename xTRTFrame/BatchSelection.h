@@ -0,0 +1,108 @@
+/** @file  BatchSelection.h
+ *  @brief Container at once selection into xTRT::BitMask
+ *
+ *  Selections which decide a whole DataVector in one call instead of
+ *  one std::function call per object. The result is a dense
+ *  xTRT::BitMask (bit i is object i of the container) or the list of
+ *  passing indices; xTRT::Algorithm::selectedContainer builds views
+ *  and deep copies from a mask.
+ *
+ *  xTRT::selectMask takes any callable (inlined, no type erasure).
+ *  xTRT::ColumnSelection cuts directly on aux columns (e.g. pt, eta,
+ *  hit counts): every cut is one pass over a contiguous float or
+ *  uint8 array without branches, which the compiler can vectorize.
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_BatchSelection_h
+#define xTRTFrame_BatchSelection_h
+
+// C++
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ATLAS
+#include <AthContainers/AuxElement.h>
+#include <AthContainers/DataVector.h>
+
+// xTRTFrame
+#include <xTRTFrame/AuxColumn.h>
+#include <xTRTFrame/BitMask.h>
+
+namespace xTRT {
+
+  /// smallest float x (in MeV) with x*toGeV >= minGeV
+  /**
+   *  Comparing a MeV value x against the result, (x < result), gives
+   *  exactly the same answer as the GeV comparison (x*toGeV < minGeV)
+   *  used by the per object selections, for every float x.
+   *
+   *  @param minGeV the minimum in GeV
+   */
+  float minimumMeV(const float minGeV);
+
+  /// set bit i of mask (resized to the container size) if pass(raw[i])
+  template <class T, class F>
+  void selectMask(const DataVector<T>* raw, F&& pass, xTRT::BitMask& mask);
+
+  /** @class xTRT::ColumnSelection
+   *  @brief Cuts on aux columns of a DataVector<T>, evaluated column by column
+   *
+   *  example:
+   *
+   *      xTRT::ColumnSelection<xAOD::Electron> kin;
+   *      kin.atLeast("pt",xTRT::minimumMeV(25)).absAtMost("eta",2.0);
+   *      xTRT::BitMask mask;
+   *      kin.select(electronContainer(),mask);
+   *
+   *  The cuts are written like the per object ones (fail if value <
+   *  minimum, fail if |value| > maximum), so NaN values pass. A cut on
+   *  a column which is not in the file is skipped (with a warning
+   *  once per file, see xTRT::auxSpan).
+   */
+  template <class T>
+  class ColumnSelection {
+
+  private:
+    template <class V, class L>
+    struct ColumnCut {
+      SG::AuxElement::ConstAccessor<V> acc;
+      std::string                      name;
+      L                                limit;
+    };
+
+    std::vector<ColumnCut<float,float>> m_minimums;    ///< fail if value < limit
+    std::vector<ColumnCut<float,float>> m_absMaximums; ///< fail if |value| > limit
+    std::vector<ColumnCut<uint8_t,int>> m_counts;      ///< fail if value < limit
+
+    mutable std::vector<uint8_t> m_keep; ///< per object scratch
+
+  public:
+    ColumnSelection() = default;
+
+    /// require the float column name to be >= minimum
+    ColumnSelection& atLeast(const std::string& name, const float minimum);
+    /// require the absolute value of the float column name to be <= maximum
+    ColumnSelection& absAtMost(const std::string& name, const float maximum);
+    /// require the uint8 column (e.g. a hit count) name to be >= minimum
+    ColumnSelection& countAtLeast(const std::string& name, const int minimum);
+
+    /// number of cuts
+    std::size_t nCuts() const { return m_minimums.size() + m_absMaximums.size() + m_counts.size(); }
+
+    /// set bit i of mask (resized to the container size) if raw[i] passes all cuts
+    void select(const DataVector<T>* raw, xTRT::BitMask& mask) const;
+    /// indices of the objects in raw passing all cuts
+    std::vector<std::size_t> indices(const DataVector<T>* raw) const;
+
+  };
+
+}
+
+#include "BatchSelection.icc"
+
+#endif
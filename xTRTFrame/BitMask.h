@@ -0,0 +1,116 @@
+/** @file  BitMask.h
+ *  @brief xTRT::BitMask class header
+ *  @class xTRT::BitMask
+ *  @brief Dynamically sized bit set indexed like a container
+ *
+ *  One bit per object of a container (bit i is object i), stored in
+ *  64 bit words. Used to keep per-object selection decisions so that
+ *  later stages (pairing, container building) only look at objects
+ *  which passed, see xTRT::BitMask::forEach. Resizing clears all
+ *  bits but keeps the allocated memory, so a mask can be reused from
+ *  event to event.
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_BitMask_h
+#define xTRTFrame_BitMask_h
+
+// C++
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace xTRT {
+
+  class BitMask {
+
+  private:
+    std::vector<uint64_t> m_words;
+    std::size_t           m_size{0};
+
+    static std::size_t nWords(const std::size_t n) { return (n + 63) / 64; }
+
+  public:
+    BitMask() = default;
+    explicit BitMask(const std::size_t n) { resize(n); }
+
+    /// set the number of bits to n, all bits cleared
+    void resize(const std::size_t n) {
+      m_size = n;
+      m_words.assign(nWords(n),0);
+    }
+
+    /// set the number of bits to n, bit i set if flags[i] is nonzero
+    void assign(const uint8_t* flags, const std::size_t n) {
+      resize(n);
+      for ( std::size_t i = 0; i < n; ++i ) {
+        m_words[i >> 6] |= uint64_t(flags[i] != 0) << (i & 63);
+      }
+    }
+
+    /// number of bits
+    std::size_t size() const { return m_size; }
+
+    /// set bit i
+    void set(const std::size_t i)   { m_words[i >> 6] |=  (uint64_t(1) << (i & 63)); }
+    /// clear bit i
+    void reset(const std::size_t i) { m_words[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    /// set bit i to value v
+    void set(const std::size_t i, const bool v) {
+      const uint64_t bit = uint64_t(1) << (i & 63);
+      m_words[i >> 6] = ( v ? (m_words[i >> 6] | bit) : (m_words[i >> 6] & ~bit) );
+    }
+    /// value of bit i
+    bool test(const std::size_t i) const { return (m_words[i >> 6] >> (i & 63)) & 1; }
+
+    /// number of set bits
+    std::size_t count() const {
+      std::size_t n = 0;
+      for ( const auto w : m_words ) n += __builtin_popcountll(w);
+      return n;
+    }
+
+    /// true if any bit is set
+    bool any() const {
+      for ( const auto w : m_words ) if ( w ) return true;
+      return false;
+    }
+
+    /// keep only bits also set in other (same size)
+    BitMask& operator&=(const BitMask& other) {
+      for ( std::size_t i = 0; i < m_words.size(); ++i ) m_words[i] &= other.m_words[i];
+      return *this;
+    }
+
+    /// add bits set in other (same size)
+    BitMask& operator|=(const BitMask& other) {
+      for ( std::size_t i = 0; i < m_words.size(); ++i ) m_words[i] |= other.m_words[i];
+      return *this;
+    }
+
+    /// call f(i) for every set bit i, in increasing order
+    template <class F>
+    void forEach(F f) const {
+      for ( std::size_t iw = 0; iw < m_words.size(); ++iw ) {
+        uint64_t w = m_words[iw];
+        while ( w ) {
+          f((iw << 6) + __builtin_ctzll(w));
+          w &= (w - 1);
+        }
+      }
+    }
+
+    /// indices of the set bits, in increasing order
+    std::vector<std::size_t> indices() const {
+      std::vector<std::size_t> idx;
+      idx.reserve(count());
+      forEach([&idx](const std::size_t i) { idx.push_back(i); });
+      return idx;
+    }
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,80 @@
+/** @file  CompiledTrackSelection.h
+ *  @brief xTRT::CompiledTrackSelection class header
+ *  @class xTRT::CompiledTrackSelection
+ *  @brief The config file track cuts, prepared once for fast evaluation
+ *
+ *  Built from xTRT::Config (in xTRT::Algorithm::initialize), this
+ *  holds the Tracks.* cuts of xTRT::Algorithm::passTrackSelection
+ *  ready to be compared against xTRT::TrackSummary records without
+ *  any config lookups or unit conversions per object:
+ *
+ *  - the p and pT thresholds are converted to MeV, to the smallest
+ *    float value whose GeV value passes, so every decision is
+ *    identical to the GeV comparison in passTrackSelection;
+ *  - cuts which can't reject anything (hit count minimums <= 0,
+ *    NaN thresholds) are dropped, which leaves their thresholds at
+ *    values every track passes.
+ *
+ *  xTRT::CompiledTrackSelection::select evaluates a whole array of
+ *  summaries in one loop, without branches per cut, into a
+ *  xTRT::BitMask.
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_CompiledTrackSelection_h
+#define xTRTFrame_CompiledTrackSelection_h
+
+// C++
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+
+// xTRTFrame
+#include <xTRTFrame/BitMask.h>
+#include <xTRTFrame/TrackSummary.h>
+
+namespace xTRT {
+
+  class Config;
+
+  class CompiledTrackSelection {
+
+  private:
+    // disabled cuts keep thresholds which pass everything
+    int   m_minNTRT{0};
+    int   m_minNTRTprec{0};
+    int   m_minNSi{0};
+    float m_minPT{-std::numeric_limits<float>::infinity()};
+    float m_maxAbsEta{std::numeric_limits<float>::infinity()};
+    float m_minP{-std::numeric_limits<float>::infinity()};
+    int   m_nCuts{0};
+
+  public:
+    /// a selection passing every track
+    CompiledTrackSelection() = default;
+    /// compile the Tracks.* cuts of the config
+    explicit CompiledTrackSelection(const xTRT::Config* conf);
+
+    /// number of cuts which are applied
+    int nCuts() const { return m_nCuts; }
+
+    /// same decision as xTRT::Algorithm::passTrackSelection
+    bool pass(const xTRT::TrackSummary& trk) const {
+      return ( trk.nTRT() >= m_minNTRT ) & ( trk.nTRT_PrecTube() >= m_minNTRTprec ) &
+        ( trk.nSilicon() >= m_minNSi ) & not ( trk.pT < m_minPT ) &
+        not ( std::abs(trk.eta) > m_maxAbsEta ) & not ( trk.p < m_minP );
+    }
+
+    /// set bit i of mask (resized to n) if tracks[i] passes
+    void select(const xTRT::TrackSummary* tracks, const std::size_t n, xTRT::BitMask& mask) const;
+
+    /// the applied cuts, in MeV
+    std::string describe() const;
+
+  };
+
+}
+
+#endif
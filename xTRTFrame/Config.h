@@ -30,6 +30,7 @@ namespace xTRT {
   private:
 
     std::unique_ptr<TEnv>    m_rootEnv;
+    std::map<std::string,std::string> m_overrides;
 
     bool                     m_mcMode;
     bool                     m_useGRL;
@@ -48,6 +49,23 @@ namespace xTRT {
 
     int m_eventPrintCounter;
 
+    float                    m_cacheSize;
+    int                      m_cacheLearnEntries;
+    bool                     m_cacheAsyncPrefetch;
+    std::vector<std::string> m_cacheBranches;
+    int                      m_cacheAutoEvents;
+
+    bool        m_timing;
+    std::string m_timingFile;
+
+    bool        m_cutFlow;
+    bool        m_cutFlowCycles;
+    std::string m_cutFlowFile;
+
+    bool m_adaptiveSelection;
+    int  m_selectionLearnEvents;
+    int  m_selectionReorderPeriod;
+
     float cut_track_p;
     float cut_track_pT;
     float cut_track_eta;
@@ -85,6 +103,17 @@ namespace xTRT {
     /// sets all the config members
     bool parse(const std::string fileName, bool print_conf, bool mcMode = false);
 
+    /** Override an option of the config file
+     *
+     *  The value replaces whatever the config file defines for the
+     *  option (e.g. from the command line). Overrides have to be set
+     *  before xTRT::Config::parse is called.
+     *
+     *  @param name the name of the variable in the configuration file
+     *  @param value the value, as it would be written in the file
+     */
+    void setOverride(const std::string& name, const std::string& value);
+
     /// true if MC mode has been declared
     bool mcMode()  const;
     /// true if config says use GRL
@@ -116,6 +145,36 @@ namespace xTRT {
     /// get the event print "on factors of" value.
     int eventPrintCounter() const;
 
+    /// get the input TTreeCache size in MB
+    float cacheSize()          const;
+    /// get the number of entries the TTreeCache learns from (0: ROOT default)
+    int   cacheLearnEntries()  const;
+    /// true if config says to prefetch baskets asynchronously
+    bool  cacheAsyncPrefetch() const;
+    /// get the list of branches to cache (empty: let the cache learn)
+    const std::vector<std::string>& cacheBranches() const;
+    /// get the number of events to record branch reads in for the automatic cache (0: off)
+    int   cacheAutoEvents()    const;
+
+    /// true if config says to time the framework stages
+    bool timing() const;
+    /// get the name of the JSON file the stage timing is written to
+    const std::string& timingFile() const;
+
+    /// true if config says to keep cut flows of the built-in selections
+    bool cutFlow() const;
+    /// true if config says to count cycles per cut in the built-in cut flows
+    bool cutFlowCycles() const;
+    /// get the name of the JSON file the cut flows are written to
+    const std::string& cutFlowFile() const;
+
+    /// true if config says to order the electron and muon cuts adaptively
+    bool adaptiveSelection()      const;
+    /// get the number of events the adaptive selections reorder after every event
+    int  selectionLearnEvents()   const;
+    /// get the number of events between reorders after learning (0: never)
+    int  selectionReorderPeriod() const;
+
     /// get the track momentum cut (minimum cut)
     float track_p()        const;
     /// get the track transverse momentum cut (minimum cut)
@@ -214,6 +273,24 @@ inline const std::vector<std::string>& xTRT::Config::miscTriggers()       const
 
 inline int xTRT::Config::eventPrintCounter() const { return m_eventPrintCounter; }
 
+inline float xTRT::Config::cacheSize()          const { return m_cacheSize;          }
+inline int   xTRT::Config::cacheLearnEntries()  const { return m_cacheLearnEntries;  }
+inline bool  xTRT::Config::cacheAsyncPrefetch() const { return m_cacheAsyncPrefetch; }
+inline int   xTRT::Config::cacheAutoEvents()    const { return m_cacheAutoEvents;    }
+
+inline const std::vector<std::string>& xTRT::Config::cacheBranches() const { return m_cacheBranches; }
+
+inline bool               xTRT::Config::timing()     const { return m_timing;     }
+inline const std::string& xTRT::Config::timingFile() const { return m_timingFile; }
+
+inline bool               xTRT::Config::cutFlow()       const { return m_cutFlow;       }
+inline bool               xTRT::Config::cutFlowCycles() const { return m_cutFlowCycles; }
+inline const std::string& xTRT::Config::cutFlowFile()   const { return m_cutFlowFile;   }
+
+inline bool xTRT::Config::adaptiveSelection()      const { return m_adaptiveSelection;      }
+inline int  xTRT::Config::selectionLearnEvents()   const { return m_selectionLearnEvents;   }
+inline int  xTRT::Config::selectionReorderPeriod() const { return m_selectionReorderPeriod; }
+
 inline float xTRT::Config::track_p()        const { return cut_track_p;        }
 inline float xTRT::Config::track_pT()       const { return cut_track_pT;       }
 inline float xTRT::Config::track_eta()      const { return cut_track_eta;      }
@@ -0,0 +1,145 @@
+/** @file  CutFlow.h
+ *  @brief xTRT::CutFlow class header
+ *  @class xTRT::CutFlow
+ *  @brief Named cut counters (and optional cost) for a selection
+ *
+ *  A selection function evaluates its cuts through a
+ *  xTRT::CutFlow::Entry. For every cut the cut flow counts how many
+ *  objects reached it and how many it rejected. It can also sum the
+ *  CPU cycles spent evaluating it (the time stamp counter on x86, ns
+ *  elsewhere). Cuts are registered the first time they are
+ *  evaluated, so their order is the order of the selection code.
+ *
+ *  The Entry is built from a possibly null cut flow pointer. Without
+ *  a cut flow it just evaluates the cut, so a selection can always
+ *  be written one way:
+ *
+ *      bool passFoo(const Foo* foo, xTRT::CutFlow* cutflow = nullptr) {
+ *        xTRT::CutFlow::Entry cf(cutflow);
+ *        if ( cf.fails("pT", [&]{ return foo->pt() < 5000; }) ) return false;
+ *        if ( cf.fails("iso",[&]{ return expensiveIso(foo) > 0.1; }) ) return false;
+ *        return cf.accept();
+ *      }
+ *
+ *  xTRT::CutFlow::suggestedOrder ranks the cuts by their cost per
+ *  rejection. Evaluating cuts in increasing cost/rejection order
+ *  minimizes the expected cost per object if the cuts are
+ *  independent. The rates are measured in the current order, so
+ *  treat the suggestion as a hint for correlated cuts.
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_CutFlow_h
+#define xTRTFrame_CutFlow_h
+
+// C++
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TH1D;
+
+namespace xTRT {
+
+  class CutFlow {
+
+  public:
+    /// counters of one cut
+    struct Cut {
+      std::string name;
+      uint64_t    nPass{0};
+      uint64_t    nFail{0};
+      uint64_t    cycles{0}; ///< summed evaluation cost (if counted)
+      /// number of objects which reached the cut
+      uint64_t nEvaluated() const { return nPass + nFail; }
+    };
+
+  private:
+    std::string      m_name;
+    bool             m_countCycles;
+    std::vector<Cut> m_cuts;
+    uint64_t         m_nObjects{0};
+    uint64_t         m_nAccepted{0};
+
+    std::size_t index(const char* name, const std::size_t hint);
+
+  public:
+    /// a cut flow, counting evaluation cycles if countCycles is true
+    explicit CutFlow(const std::string& name, const bool countCycles = false);
+
+    /// name of the cut flow
+    const std::string& name() const { return m_name; }
+    /// true if cut evaluation cycles are counted
+    bool countCycles() const { return m_countCycles; }
+    /// all cuts, in registration order
+    const std::vector<Cut>& cuts() const { return m_cuts; }
+    /// number of objects which entered the selection
+    uint64_t nObjects() const { return m_nObjects; }
+    /// number of objects which passed all cuts
+    uint64_t nAccepted() const { return m_nAccepted; }
+
+    /// cut names ordered by increasing cost per rejected object
+    std::vector<std::string> suggestedOrder() const;
+
+    /// histogram of objects entering and passing each cut (owned by the caller)
+    TH1D* makeHistogram() const;
+
+    /// time stamp used for the cycle counts
+    static uint64_t ticks();
+
+    /// count an object entering the selection
+    void addObject() { m_nObjects++; }
+    /// count an object passing all cuts
+    void addAccepted() { m_nAccepted++; }
+
+    /// add the counters of another run of the same selection (cuts matched by name)
+    void add(const std::vector<Cut>& cuts, const uint64_t nObjects, const uint64_t nAccepted);
+
+    /// evaluate a failure predicate as cut name (the hint is the expected cut index)
+    template <class Pred>
+    bool fails(const char* name, const std::size_t hint, Pred&& pred);
+
+    /** @class xTRT::CutFlow::Entry
+     *  @brief One object going through a selection
+     */
+    class Entry {
+    private:
+      CutFlow*    m_flow;
+      std::size_t m_pos{0};
+    public:
+      /// start an object (flow may be null)
+      explicit Entry(CutFlow* flow) : m_flow(flow) {
+        if ( m_flow ) m_flow->addObject();
+      }
+      /// true if pred is true (the object fails the cut)
+      template <class Pred>
+      bool fails(const char* name, Pred&& pred);
+      /// count the object as accepted, returns true
+      bool accept() {
+        if ( m_flow ) m_flow->addAccepted();
+        return true;
+      }
+    };
+
+  };
+
+  /// write the counters and suggested orders of cut flows to a JSON file
+  bool writeCutFlowJSON(const std::string& fileName, const std::vector<const xTRT::CutFlow*>& flows);
+
+  /// sum the cut flows of JSON files written by writeCutFlowJSON into one file
+  /**
+   *  Cut flows are matched by name, their cuts by cut name; the
+   *  suggested orders are recomputed from the sums.
+   *
+   *  @param inputs the files to merge
+   *  @param output the merged file
+   */
+  bool mergeCutFlowJSON(const std::vector<std::string>& inputs, const std::string& output);
+
+}
+
+#include "CutFlow.icc"
+
+#endif
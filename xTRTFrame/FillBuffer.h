@@ -0,0 +1,122 @@
+/** @file  FillBuffer.h
+ *  @brief xTRT::FillBuffer class header
+ *  @class xTRT::FillBuffer
+ *  @brief Batches fills of a 1D histogram
+ *
+ *  Values and weights are collected in two arrays and handed to the
+ *  histogram in one go (TH1::FillN) when the buffer is full, and at
+ *  the end of every event (xTRT::Algorithm::postExecute flushes all
+ *  buffers made with xTRT::Algorithm::createBuffered).
+ *
+ *  With the pre-binned mode (default) a histogram with a fixed bin
+ *  width axis is filled by computing the bin directly (the formula
+ *  of TAxis::FindFixBin) and adding to the bin contents, sum of
+ *  weights squared and statistics, skipping the generic TH1::Fill
+ *  machinery. Histograms with variable bins or extendable axes fall
+ *  back to FillN; anything but a plain 1D histogram (profiles, 2D,
+ *  ...) is filled directly.
+ *
+ *  The number of flushed entries and the time spent flushing are
+ *  kept for the job summary (see xTRT::FillBuffer::entries and
+ *  xTRT::FillBuffer::seconds). As the unbuffered reference, the
+ *  first referenceSample entries flushed are also filled one by one
+ *  (TH1::Fill) into a scratch clone of the histogram, which is timed
+ *  and then deleted; the real histogram is not touched by it (see
+ *  xTRT::FillBuffer::referenceEntries and
+ *  xTRT::FillBuffer::referenceSeconds).
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_FillBuffer_h
+#define xTRTFrame_FillBuffer_h
+
+// C++
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// ROOT
+#include <TH1.h>
+
+namespace xTRT {
+
+  class FillBuffer {
+
+  private:
+    TH1*                m_hist;
+    std::vector<double> m_x;
+    std::vector<double> m_w;
+    std::size_t         m_capacity;
+    bool                m_direct;
+    bool                m_prebinned;
+    int                 m_nbins;
+    double              m_xmin;
+    double              m_xmax;
+
+    // fill rate bookkeeping
+    std::size_t m_nEntries{0};
+    double      m_seconds{0};
+
+    // unbuffered reference (TH1::Fill into a scratch clone)
+    std::unique_ptr<TH1> m_reference;
+    std::size_t          m_referenceSample;
+    std::size_t          m_nReference{0};
+    double               m_referenceSeconds{0};
+
+    void flushPrebinned();
+    void fillReference();
+
+  public:
+    /// create a buffer for hist holding up to capacity entries
+    /**
+     *  @param hist the histogram to fill
+     *  @param capacity number of entries staged before a flush
+     *  @param prebinned use the pre-binned fast path if possible
+     *  @param referenceSample number of entries also timed with
+     *  unbuffered TH1::Fill calls (0: no reference)
+     */
+    FillBuffer(TH1* hist, const std::size_t capacity = 4096, const bool prebinned = true,
+               const std::size_t referenceSample = 100000);
+    ~FillBuffer() = default;
+
+    FillBuffer(const FillBuffer&) = delete;
+    FillBuffer& operator=(const FillBuffer&) = delete;
+
+    /// stage a fill (flushes when the buffer is full)
+    void fill(const double x, const double w = 1.0) {
+      if ( m_direct ) {
+        m_hist->Fill(x,w);
+        return;
+      }
+      m_x.push_back(x);
+      m_w.push_back(w);
+      if ( m_x.size() >= m_capacity ) flush();
+    }
+
+    /// same as fill, TH1-like spelling
+    void Fill(const double x, const double w = 1.0) { fill(x,w); }
+
+    /// push all staged entries to the histogram
+    void flush();
+
+    /// the histogram being filled
+    TH1* hist() const { return m_hist; }
+
+    /// true if the pre-binned fast path is used
+    bool prebinned() const { return m_prebinned; }
+
+    /// number of entries flushed so far
+    std::size_t entries() const { return m_nEntries; }
+    /// time spent flushing so far
+    double      seconds() const { return m_seconds; }
+    /// number of entries filled unbuffered into the reference clone
+    std::size_t referenceEntries() const { return m_nReference; }
+    /// time spent on the unbuffered reference fills
+    double      referenceSeconds() const { return m_referenceSeconds; }
+
+  };
+
+}
+
+#endif
@@ -7,6 +7,8 @@
 #ifndef xTRTFrame_Helpers_h
 #define xTRTFrame_Helpers_h
 
+#include <cstddef>
+
 #include <xTRTFrame/Utils.h>
 #include <xAODTracking/TrackMeasurementValidationContainer.h>
 
@@ -48,6 +50,88 @@ namespace xTRT {
     NONTRT = 3  ///< not in TRT
   };
 
+  /*!
+    \enum ContainerMode
+    How a container of selected objects is built
+  */
+  enum ContainerMode {
+    VIEW     = 0, ///< view (SG::VIEW_ELEMENTS) of pointers into the original container
+    DEEPCOPY = 1  ///< deep copy of each selected object and its aux data
+  };
+
+  /// compile time TRT geometry tables used by the helper functions
+  /**
+   *  The [2][14] tables are indexed by [0 for barrel, 1 for end
+   *  cap][barrel layer or end cap wheel]; unused barrel entries are 0.
+   */
+  namespace Lookup {
+
+    /// number of straw layers in each barrel layer / end cap wheel
+    constexpr int nStrawLayers[2][14] = {
+      {19, 24, 30,  0,  0,  0, 0, 0, 0, 0, 0, 0, 0, 0},
+      {16, 16, 16, 16, 16, 16, 8, 8, 8, 8, 8, 8, 8, 8}
+    };
+
+    /// absolute straw layer of the first straw layer in each barrel layer / end cap wheel
+    constexpr int strawLayerOffset[2][14] = {
+      { 0, 19, 43,  0,  0,  0,  0,   0,   0,   0,   0,   0,   0,   0},
+      { 0, 16, 32, 48, 64, 80, 96, 104, 112, 120, 128, 136, 144, 152}
+    };
+
+    /// straw region (module/wheel type) of each barrel layer / end cap wheel
+    constexpr StrawRegion layerRegion[2][14] = {
+      {BRL, BRL, BRL, NOTTRT, NOTTRT, NOTTRT, NOTTRT, NOTTRT, NOTTRT, NOTTRT, NOTTRT, NOTTRT, NOTTRT, NOTTRT},
+      {ECA, ECA, ECA, ECA, ECA, ECA, ECB, ECB, ECB, ECB, ECB, ECB, ECB, ECB}
+    };
+
+    /// side region for bec + 2 (bec in [-2,2])
+    constexpr SideRegion becToSide[5] = {SIDE_C, BARREL, NONTRT, BARREL, SIDE_A};
+
+    /// |eta| lower edges of the straw regions after BRL (BRLECA, ECA, ECAECB, ECB, NOTTRT)
+    constexpr double strawRegionEdges[5] = {0.625, 1.070, 1.304, 1.752, 2.000};
+
+  }
+
+  /// straw region code (xTRT::StrawRegion) for an |eta| value
+  /**
+   *  Counts the region edges at or below |eta| (a NaN gives NOTTRT,
+   *  like xTRT::getStrawRegion).
+   */
+  constexpr int strawRegionCode(const float absEta) {
+    return !(absEta < Lookup::strawRegionEdges[0]) + !(absEta < Lookup::strawRegionEdges[1])
+      +    !(absEta < Lookup::strawRegionEdges[2]) + !(absEta < Lookup::strawRegionEdges[3])
+      +    !(absEta < Lookup::strawRegionEdges[4]);
+  }
+
+  /// side region code (xTRT::SideRegion) for a bec value (NONTRT if bad)
+  constexpr int sideRegionCode(const int bec) {
+    return Lookup::becToSide[ ( static_cast<unsigned>(bec + 2) < 5u ) ? bec + 2 : 2 ];
+  }
+
+  /// absolute straw layer of a hit, -1 if the identifiers are bad
+  /**
+   *  Barrel absolute straw layers are in [0,73), end cap ones in
+   *  [0,160) (see xTRT::absoluteBarrelSL and xTRT::absoluteEndCapSL,
+   *  which exit on bad input instead).
+   *
+   *  @param bec the barrel/endcap value
+   *  @param layer the layer (barrel) or wheel (end cap)
+   *  @param sl the straw layer in the layer/wheel
+   */
+  constexpr int absoluteStrawLayer(const int bec, const int layer, const int sl) {
+    const int  ec = ( bec == 2 || bec == -2 );
+    const bool ok = ( ec || bec == 1 || bec == -1 ) && ( static_cast<unsigned>(layer) < 14u );
+    const int  l  = ok ? layer : 0;
+    return ( ok && static_cast<unsigned>(sl) < static_cast<unsigned>(Lookup::nStrawLayers[ec][l]) )
+      ? Lookup::strawLayerOffset[ec][l] + sl : -1;
+  }
+
+  /// straw region code (BRL, ECA, ECB or NOTTRT) of a hit from its bec and layer
+  constexpr int layerRegionCode(const int bec, const int layer) {
+    return ( ( bec == 2 || bec == -2 || bec == 1 || bec == -1 ) && static_cast<unsigned>(layer) < 14u )
+      ? Lookup::layerRegion[( bec == 2 || bec == -2 )][layer] : NOTTRT;
+  }
+
   /** \addtogroup GenHelpers Generic Helper Functions
    *  \brief Some misc. functions to make life easier
    *  @{
@@ -90,6 +174,42 @@ namespace xTRT {
    */
   int absoluteEndCapSL(const int sl, const int wheel);
 
+  /// batch version of xTRT::absoluteStrawLayer (no branches, no exit on bad input)
+  /**
+   * @param bec array of n "bec" values
+   * @param layer array of n "layer" values
+   * @param sl array of n "strawlayer" values
+   * @param n number of hits
+   * @param absSL output array of n absolute straw layers (-1 if bad)
+   */
+  void absoluteStrawLayers(const int* bec, const int* layer, const int* sl,
+                           const std::size_t n, int* absSL);
+
+  /// batch version of xTRT::layerRegionCode
+  /**
+   * @param bec array of n "bec" values
+   * @param layer array of n "layer" values
+   * @param n number of hits
+   * @param region output array of n xTRT::StrawRegion codes
+   */
+  void layerRegionCodes(const int* bec, const int* layer, const std::size_t n, int* region);
+
+  /// batch version of xTRT::sideRegionCode
+  /**
+   * @param bec array of n "bec" values
+   * @param n number of hits
+   * @param side output array of n xTRT::SideRegion codes
+   */
+  void sideRegionCodes(const int* bec, const std::size_t n, int* side);
+
+  /// batch version of xTRT::getStrawRegion (no exit, codes instead of enums)
+  /**
+   * @param eta array of n pseudorapidities
+   * @param n number of entries
+   * @param region output array of n xTRT::StrawRegion codes
+   */
+  void strawRegionCodes(const float* eta, const std::size_t n, int* region);
+
   /** @} */ // end of Helpers
 
 }
@@ -0,0 +1,56 @@
+/** @file  HistHandle.h
+ *  @brief xTRT::HistHandle class header
+ *  @class xTRT::HistHandle
+ *  @brief Typed handle to an output object made with xTRT::Algorithm::create
+ *
+ *  The handle holds the pointer to the stored clone, so filling
+ *  through it needs neither the name lookup nor the dynamic_cast of
+ *  xTRT::Algorithm::grab. Keep the handle (e.g. as a member of your
+ *  algorithm, marked transient with //!) from histInitialize and use
+ *  it in the event loop:
+ *
+ *  @code{.cpp}
+ *  m_hL = create(TH1F("hL","L",100,0,10));
+ *  ...
+ *  m_hL.Fill(hit.L);
+ *  @endcode
+ *
+ *  The object is owned by EventLoop (it is added to the worker
+ *  outputs), the handle never deletes it.
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_HistHandle_h
+#define xTRTFrame_HistHandle_h
+
+#include <utility>
+
+namespace xTRT {
+
+  template <class T>
+  class HistHandle {
+
+  private:
+    T* m_obj{nullptr};
+
+  public:
+    HistHandle() = default;
+    explicit HistHandle(T* obj) : m_obj(obj) {}
+
+    /// the stored object
+    T*   get()        const { return m_obj; }
+    T*   operator->() const { return m_obj; }
+    T&   operator*()  const { return *m_obj; }
+    /// true if the handle points to an object
+    explicit operator bool() const { return m_obj != nullptr; }
+
+    /// forward to the Fill function of the stored object
+    template <class... Args>
+    int Fill(Args&&... args) const { return m_obj->Fill(std::forward<Args>(args)...); }
+
+  };
+
+}
+
+#endif
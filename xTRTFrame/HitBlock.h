@@ -0,0 +1,139 @@
+/** @file  HitBlock.h
+ *  @brief xTRT::HitBlock class header
+ *  @class xTRT::HitBlock
+ *  @brief Structure of arrays holding all TRT hits on a track
+ *
+ *  This is the batch counterpart to xTRT::HitSummary: instead of one
+ *  object per hit, every hit variable is stored in its own array
+ *  (index i of each array is hit i). A block is filled for a whole
+ *  track with xTRT::Algorithm::fillHitBlock and is meant to be reused
+ *  from track to track, so the arrays only allocate while they grow.
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_HitBlock_h
+#define xTRTFrame_HitBlock_h
+
+// C++
+#include <vector>
+#include <cstddef>
+
+// ATLAS
+#include <AthContainers/AuxVectorData.h>
+
+// xTRTFrame
+#include <xTRTFrame/HitSummary.h>
+#include <xTRTFrame/AuxColumn.h>
+
+namespace xTRT {
+
+  /** \addtogroup HitHelpers Hit Helpers
+   *  @{
+   */
+
+  struct HitBlock {
+
+    std::vector<int>   HTMB;
+    std::vector<int>   gasType;
+    std::vector<int>   bec;
+    std::vector<int>   layer;
+    std::vector<int>   phi_module;
+    std::vector<int>   strawlayer;
+    std::vector<int>   strawnumber;
+    std::vector<float> drifttime;
+    std::vector<float> tot;
+    std::vector<float> T0;
+
+    std::vector<int>   type;
+    std::vector<float> localX;
+    std::vector<float> localY;
+    std::vector<float> localTheta;
+    std::vector<float> localPhi;
+    std::vector<float> HitZ;
+    std::vector<float> HitR;
+    std::vector<float> rTrkWire;
+    std::vector<float> L;
+
+    /// number of hits in the block
+    std::size_t size() const { return bec.size(); }
+
+    /// remove all hits (keeps the allocated memory)
+    void clear() {
+      HTMB.clear(); gasType.clear(); bec.clear(); layer.clear(); phi_module.clear();
+      strawlayer.clear(); strawnumber.clear(); drifttime.clear(); tot.clear(); T0.clear(); type.clear();
+      localX.clear(); localY.clear(); localTheta.clear(); localPhi.clear(); HitZ.clear();
+      HitR.clear(); rTrkWire.clear(); L.clear();
+    }
+
+    /// make room for n hits
+    void reserve(const std::size_t n) {
+      HTMB.reserve(n); gasType.reserve(n); bec.reserve(n); layer.reserve(n); phi_module.reserve(n);
+      strawlayer.reserve(n); strawnumber.reserve(n); drifttime.reserve(n); tot.reserve(n); T0.reserve(n); type.reserve(n);
+      localX.reserve(n); localY.reserve(n); localTheta.reserve(n); localPhi.reserve(n); HitZ.reserve(n);
+      HitR.reserve(n); rTrkWire.reserve(n); L.reserve(n);
+    }
+
+    /// get hit i as a xTRT::HitSummary
+    xTRT::HitSummary hit(const std::size_t i) const {
+      xTRT::HitSummary h;
+      h.HTMB        = HTMB[i];
+      h.gasType     = gasType[i];
+      h.bec         = bec[i];
+      h.layer       = layer[i];
+      h.phi_module  = phi_module[i];
+      h.strawlayer  = strawlayer[i];
+      h.strawnumber = strawnumber[i];
+      h.drifttime   = drifttime[i];
+      h.tot         = tot[i];
+      h.T0          = T0[i];
+      h.type        = type[i];
+      h.localX      = localX[i];
+      h.localY      = localY[i];
+      h.localTheta  = localTheta[i];
+      h.localPhi    = localPhi[i];
+      h.HitZ        = HitZ[i];
+      h.HitR        = HitR[i];
+      h.rTrkWire    = rTrkWire[i];
+      h.L           = L[i];
+      return h;
+    }
+
+  };
+
+  /// aux columns of the drift circle and MSOS containers feeding a xTRT::HitBlock
+  /**
+   *  The spans are bound once per container (and event) by
+   *  xTRT::Algorithm::fillHitBlock; an unavailable variable gives an
+   *  empty span which reads as 0.
+   */
+  struct HitColumns {
+
+    const SG::AuxVectorData*   driftCircles{nullptr};
+    xTRT::AuxSpan<unsigned int> bitPattern;
+    xTRT::AuxSpan<char>         gasType;
+    xTRT::AuxSpan<int>          bec;
+    xTRT::AuxSpan<int>          layer;
+    xTRT::AuxSpan<int>          phi_module;
+    xTRT::AuxSpan<int>          strawlayer;
+    xTRT::AuxSpan<int>          strawnumber;
+    xTRT::AuxSpan<float>        drifttime;
+    xTRT::AuxSpan<float>        tot;
+    xTRT::AuxSpan<float>        T0;
+
+    const SG::AuxVectorData*   msoss{nullptr};
+    xTRT::AuxSpan<int>          type;
+    xTRT::AuxSpan<float>        localX;
+    xTRT::AuxSpan<float>        localY;
+    xTRT::AuxSpan<float>        localTheta;
+    xTRT::AuxSpan<float>        localPhi;
+    xTRT::AuxSpan<float>        HitZ;
+    xTRT::AuxSpan<float>        HitR;
+    xTRT::AuxSpan<float>        rTrkWire;
+
+  };
+
+  /** @}*/
+}
+
+#endif
@@ -0,0 +1,58 @@
+/** @file  HitKernels.h
+ *  @brief xTRTFrame kernels operating on blocks of hits
+ *
+ *  Functions in this file work on whole arrays of hit variables (see
+ *  xTRT::HitBlock) instead of one hit at a time. On x86-64 the
+ *  implementation is picked at runtime (AVX2, SSE2 or plain scalar
+ *  code).
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_HitKernels_h
+#define xTRTFrame_HitKernels_h
+
+#include <cstddef>
+
+namespace xTRT {
+
+  /** \addtogroup HitHelpers Hit Helpers
+   *  @{
+   */
+
+  /// compute the track length in straw (L) for a block of hits on one track
+  /**
+   *  Same definition as the L in xTRT::Algorithm::getHitSummary:
+   *  2*sqrt(4-rTrkWire^2) divided by |sin(theta)| in the barrel and
+   *  by sqrt(1-sin^2(theta)*cos^2(phi-localPhi)) in the end caps
+   *  (|bec| == 2). The end cap denominator is evaluated as
+   *  sqrt(cos^2(theta)+sin^2(theta)*sin^2(phi-localPhi)) to avoid
+   *  the cancellation at grazing incidence. The SIMD versions agree
+   *  with xTRT::trackLengthInStrawScalar to a relative 1e-6 for
+   *  typical hits (1e-4 in the worst grazing case).
+   *
+   *  @param rTrkWire the track to wire distance of each hit
+   *  @param localPhi the local phi of each hit
+   *  @param bec the barrel/endcap value of each hit
+   *  @param n the number of hits
+   *  @param trackTheta the theta of the track
+   *  @param trackPhi the phi of the track
+   *  @param L output array (n entries)
+   */
+  void trackLengthInStraw(const float* rTrkWire, const float* localPhi, const int* bec,
+                          const std::size_t n, const float trackTheta, const float trackPhi,
+                          float* L);
+
+  /// scalar reference version of xTRT::trackLengthInStraw
+  void trackLengthInStrawScalar(const float* rTrkWire, const float* localPhi, const int* bec,
+                                const std::size_t n, const float trackTheta, const float trackPhi,
+                                float* L);
+
+  /// name of the implementation used by xTRT::trackLengthInStraw ("AVX2", "SSE2" or "scalar")
+  const char* trackLengthInStrawImpl();
+
+  /** @}*/
+
+}
+
+#endif
@@ -0,0 +1,152 @@
+/** @file  HitNtupleWriter.h
+ *  @brief xTRT::HitNtupleWriter class header
+ *  @class xTRT::HitNtupleWriter
+ *  @brief Writes tracks and their TRT hits to a flat, compact TTree
+ *
+ *  One tree entry is one event. Track variables are arrays of length
+ *  nTracks and hit variables are arrays of length nHits, the hits of
+ *  all tracks concatenated (no vector<vector> branches). The hits of
+ *  track i are [trk_hitBegin[i], trk_hitBegin[i+1]) (the last track
+ *  ends at nHits).
+ *
+ *  Small values are packed:
+ *  - hit_bits (UChar_t): bit 0 is HTMB, bits 1-2 are gasType
+ *  - hit_bec (Char_t), hit_layer, hit_strawlayer, hit_phi_module,
+ *    hit_strawnumber, hit_type (UChar_t)
+ *  - track hit counts (UChar_t)
+ *
+ *  Branches are created with large baskets and LZ4 compression and
+ *  the tree flushes in large clusters, which is what repeated
+ *  sequential reads of whole files want (decompression speed over
+ *  size). All of these can be changed in the constructor.
+ *
+ *  Usage (see xTRT::Algorithm::createHitNtuple):
+ *
+ *      auto writer = createHitNtuple("hits");   // in initialize
+ *      ...
+ *      writer->setEventInfo(eventWeight(),averageMu()); // in execute
+ *      for ( track : tracks ) {
+ *        fillHitBlock(track,block);
+ *        writer->addTrack(trackSummary(track),block);
+ *      }
+ *      writer->fill();
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_HitNtupleWriter_h
+#define xTRTFrame_HitNtupleWriter_h
+
+// C++
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// xTRTFrame
+#include <xTRTFrame/HitBlock.h>
+#include <xTRTFrame/TrackSummary.h>
+
+class TTree;
+class TBranch;
+
+namespace xTRT {
+
+  class HitNtupleWriter {
+
+  private:
+    TTree* m_tree;
+    int    m_compression;
+
+    // event
+    float    m_weight{1.0};
+    float    m_mu{0.0};
+    uint32_t m_nTracks{0};
+    uint32_t m_nHits{0};
+
+    // tracks
+    std::vector<float>    m_trk_pT;
+    std::vector<float>    m_trk_eta;
+    std::vector<float>    m_trk_p;
+    std::vector<float>    m_trk_theta;
+    std::vector<uint8_t>  m_trk_nTRTHits;
+    std::vector<uint8_t>  m_trk_nTRTOutliers;
+    std::vector<uint8_t>  m_trk_nTRTHTHits;
+    std::vector<uint8_t>  m_trk_nPixelHits;
+    std::vector<uint8_t>  m_trk_nSCTHits;
+    std::vector<uint32_t> m_trk_hitBegin;
+
+    // hits
+    std::vector<uint8_t> m_hit_bits;
+    std::vector<int8_t>  m_hit_bec;
+    std::vector<uint8_t> m_hit_layer;
+    std::vector<uint8_t> m_hit_strawlayer;
+    std::vector<uint8_t> m_hit_phi_module;
+    std::vector<uint8_t> m_hit_strawnumber;
+    std::vector<uint8_t> m_hit_type;
+    std::vector<float>   m_hit_drifttime;
+    std::vector<float>   m_hit_tot;
+    std::vector<float>   m_hit_T0;
+    std::vector<float>   m_hit_localX;
+    std::vector<float>   m_hit_localY;
+    std::vector<float>   m_hit_localTheta;
+    std::vector<float>   m_hit_localPhi;
+    std::vector<float>   m_hit_HitZ;
+    std::vector<float>   m_hit_HitR;
+    std::vector<float>   m_hit_rTrkWire;
+    std::vector<float>   m_hit_L;
+
+    // array branches and the column feeding each one (the address is
+    // refreshed before every fill since the columns may reallocate)
+    struct Binding {
+      TBranch* branch;
+      void*    column;
+      void*    (*data)(void*);
+    };
+    std::vector<Binding> m_bindings;
+
+    template <class T>
+    static void* columnData(void* column) { return static_cast<std::vector<T>*>(column)->data(); }
+
+    template <class T>
+    void addColumn(const std::string& name, std::vector<T>& column, const char type,
+                   const char* count, const int basketSize);
+
+    void addScalar(const std::string& name, void* address, const char type);
+
+  public:
+    /// create the branches on tree
+    /**
+     *  @param tree the output tree (e.g. from SETUP_OUTPUT_TREE)
+     *  @param basketSize basket size of the hit branches in bytes
+     *  (track branches use 1/8 of it)
+     *  @param autoFlush TTree::SetAutoFlush value (< 0: cluster size in bytes)
+     *  @param compression ROOT compression setting of the branches (404: LZ4 level 4)
+     */
+    HitNtupleWriter(TTree* tree, const int basketSize = 512*1024,
+                    const long long autoFlush = -64LL*1024*1024, const int compression = 404);
+    ~HitNtupleWriter() = default;
+
+    HitNtupleWriter(const HitNtupleWriter&) = delete;
+    HitNtupleWriter& operator=(const HitNtupleWriter&) = delete;
+
+    /// set the event level variables for the current entry
+    void setEventInfo(const float weight, const float mu) {
+      m_weight = weight;
+      m_mu     = mu;
+    }
+
+    /// add a track and all hits in its block to the current entry
+    void addTrack(const xTRT::TrackSummary& track, const xTRT::HitBlock& hits);
+
+    /// write the current entry and start a new (empty) one
+    void fill();
+
+    /// the output tree
+    TTree* tree() const { return m_tree; }
+
+  };
+
+}
+
+#endif
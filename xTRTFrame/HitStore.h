@@ -0,0 +1,189 @@
+/** @file  HitStore.h
+ *  @brief xTRT::HitStoreWriter and xTRT::HitStoreReader class headers
+ *
+ *  A hit store is a single binary file holding the hit level
+ *  (xTRT::HitSummary) data of many tracks, one contiguous array per
+ *  variable, meant to be memory mapped and scanned many times after
+ *  a skim without any deserialization:
+ *
+ *      "XTRTHITS" | uint32 version | uint32 header size | JSON header
+ *      | padding | column 0 | padding | column 1 | ...
+ *
+ *  The data section and every column in it start on a 4096 byte
+ *  boundary. The JSON header holds the version, the number of hits
+ *  and tracks and, for every column, its name, element type ("f32",
+ *  "u32", "u64", "i8", "u8"), byte offset from the start of the data
+ *  section and number of elements. Hit columns are indexed by hit and
+ *  track columns by track; the hits of track i are
+ *  [trk_hitBegin[i], trk_hitBegin[i+1]) (the last track ends at
+ *  nHits).
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_HitStore_h
+#define xTRTFrame_HitStore_h
+
+// C++
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// xTRTFrame
+#include <xTRTFrame/HitBlock.h>
+#include <xTRTFrame/TrackSummary.h>
+#include <xTRTFrame/AuxColumn.h>
+
+namespace xTRT {
+
+  class HitStoreReader;
+
+  /// hit store format version (written to and checked against the header)
+  constexpr uint32_t hitStoreVersion = 1;
+
+  /** @class xTRT::HitStoreWriter
+   *  @brief Exports tracks and their hits to a hit store file
+   *
+   *  Each column is streamed to its own temporary file next to the
+   *  output while tracks are added; xTRT::HitStoreWriter::close
+   *  writes the header and concatenates the columns into the final
+   *  file (and removes the temporary files).
+   */
+  class HitStoreWriter {
+
+  private:
+    struct Column {
+      std::string   name;
+      std::string   type;
+      std::size_t   elemSize;
+      std::string   tmpName;
+      std::ofstream out;
+      std::size_t   size{0};
+    };
+
+    std::string                          m_fileName;
+    std::vector<std::unique_ptr<Column>> m_columns;
+    uint64_t                             m_nHits{0};
+    uint64_t                             m_nTracks{0};
+    bool                                 m_closed{false};
+
+    void addColumn(const std::string& name, const std::string& type, const std::size_t elemSize);
+
+    template <class T>
+    void write(Column& column, const T* data, const std::size_t n);
+    template <class T, class U>
+    void writeAs(Column& column, const std::vector<U>& data);
+
+  public:
+    /// start a new store (the file is written by close)
+    explicit HitStoreWriter(const std::string& fileName);
+    /// closes the store if not done yet
+    ~HitStoreWriter();
+
+    HitStoreWriter(const HitStoreWriter&) = delete;
+    HitStoreWriter& operator=(const HitStoreWriter&) = delete;
+
+    /// add a track, its weight, and all hits in its block
+    void addTrack(const xTRT::TrackSummary& track, const xTRT::HitBlock& hits, const float weight = 1.0);
+
+    /// add all tracks and hits of an existing store (after those already added)
+    void append(const xTRT::HitStoreReader& store);
+
+    /// write the final file
+    bool close();
+
+    /// number of hits added so far
+    uint64_t nHits()   const { return m_nHits; }
+    /// number of tracks added so far
+    uint64_t nTracks() const { return m_nTracks; }
+
+  };
+
+  /** @class xTRT::HitStoreReader
+   *  @brief Read only, zero copy access to a hit store file
+   *
+   *  The file is mapped shared and read only, so any number of
+   *  processes scanning the same store share the page cache. Columns
+   *  are handed out as xTRT::AuxSpan views into the mapping (valid as
+   *  long as the reader lives).
+   *
+   *  example:
+   *
+   *      xTRT::HitStoreReader store("hits.xtrt");
+   *      auto tot  = store.column<float>("hit_tot");
+   *      auto HTMB = store.column<uint8_t>("hit_HTMB");
+   *      for ( std::size_t i = 0; i < tot.size(); ++i ) { ... }
+   */
+  class HitStoreReader {
+
+  private:
+    struct ColumnInfo {
+      std::string type;
+      std::size_t offset;
+      std::size_t size;
+    };
+
+    std::string                       m_fileName;
+    const char*                       m_data{nullptr};
+    std::size_t                       m_fileSize{0};
+    uint64_t                          m_nHits{0};
+    uint64_t                          m_nTracks{0};
+    std::map<std::string,ColumnInfo>  m_columns;
+
+    const void* columnData(const std::string& name, const std::string& type, std::size_t& size) const;
+
+  public:
+    /// map the file and read its header (exits on a bad file)
+    explicit HitStoreReader(const std::string& fileName);
+    /// unmap the file
+    ~HitStoreReader();
+
+    HitStoreReader(const HitStoreReader&) = delete;
+    HitStoreReader& operator=(const HitStoreReader&) = delete;
+
+    /// number of hits in the store
+    uint64_t nHits()   const { return m_nHits; }
+    /// number of tracks in the store
+    uint64_t nTracks() const { return m_nTracks; }
+    /// names of the stored columns
+    std::vector<std::string> columnNames() const;
+
+    /// view of a column (T must match the stored type, exits otherwise)
+    template <class T>
+    xTRT::AuxSpan<T> column(const std::string& name) const;
+
+    /// tell the kernel the whole file will be read sequentially
+    void adviseSequential() const;
+
+  };
+
+  /// true if the file starts like a hit store
+  bool isHitStore(const std::string& fileName);
+
+  /// concatenate hit stores (tracks in the order of the inputs) into a new store
+  /**
+   *  Used by xTRT::Runner to merge the stores written by the ranges
+   *  of a --jobs run. Exits if an input is not a valid store.
+   *
+   *  @param inputs the stores to merge
+   *  @param output the merged store file name
+   */
+  bool mergeHitStores(const std::vector<std::string>& inputs, const std::string& output);
+
+  /// hit store type name of T ("f32", "u32", "u64", "i8", "u8")
+  template <class T> constexpr const char* hitStoreType();
+  template <> constexpr const char* hitStoreType<float>()    { return "f32"; }
+  template <> constexpr const char* hitStoreType<uint32_t>() { return "u32"; }
+  template <> constexpr const char* hitStoreType<uint64_t>() { return "u64"; }
+  template <> constexpr const char* hitStoreType<int8_t>()   { return "i8";  }
+  template <> constexpr const char* hitStoreType<uint8_t>()  { return "u8";  }
+
+}
+
+#include "HitStore.icc"
+
+#endif
@@ -26,6 +26,7 @@ namespace xTRT {
     int   gasType;
     int   bec;
     int   layer;
+    int   phi_module;
     int   strawlayer;
     int   strawnumber;
     float drifttime;
@@ -0,0 +1,139 @@
+/** @file  SelectionEngine.h
+ *  @brief xTRT::SelectionEngine class header
+ *
+ *  A selection engine holds a selection as a list of named cuts
+ *  (predicates, true if the object passes) and evaluates them in the
+ *  order which is currently cheapest. For every cut it measures the
+ *  cost per evaluation (cycles, see xTRT::CutFlow::ticks) and the
+ *  fraction of objects reaching it which it rejects. Independent
+ *  cuts are cheapest in increasing cost/rejection order, so the
+ *  engine sorts by that. It reorders after every event during the
+ *  first learnEvents events, and then every reorderPeriod events
+ *  with the older measurements halved so the order can follow
+ *  changes in the input. After learning only one object in 16 is
+ *  timed.
+ *
+ *  An object is accepted only if all cuts pass, so the decision does
+ *  not depend on the order as long as the cuts have no side effects
+ *  (messages aside).
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_SelectionEngine_h
+#define xTRTFrame_SelectionEngine_h
+
+// C++
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// xTRTFrame
+#include <xTRTFrame/CutFlow.h>
+
+namespace xTRT {
+
+  /** @class xTRT::SelectionEngineBase
+   *  @brief Cut statistics and ordering of a xTRT::SelectionEngine
+   */
+  class SelectionEngineBase {
+
+  public:
+    /// measurements of one cut
+    struct CutStats {
+      std::string name;
+      double      nEval{0};  ///< objects which reached the cut
+      double      nFail{0};  ///< objects rejected by the cut
+      double      nTimed{0}; ///< evaluations which were timed
+      double      cycles{0}; ///< cycles of the timed evaluations
+    };
+
+  protected:
+    std::string              m_name;
+    std::vector<CutStats>    m_stats;
+    std::vector<std::size_t> m_order;
+    uint64_t                 m_nEvents{0};
+    uint64_t                 m_nObjects{0};
+    uint64_t                 m_nReorders{0};
+    uint64_t                 m_learnEvents;
+    uint64_t                 m_reorderPeriod;
+
+    /// register a cut, at the end of the order
+    void addStats(const std::string& name);
+    /// true if the next object is timed
+    bool timeObject() {
+      return ( m_nEvents < m_learnEvents ) || ( (m_nObjects & 15) == 0 );
+    }
+
+  public:
+    SelectionEngineBase(const std::string& name, const uint64_t learnEvents, const uint64_t reorderPeriod);
+    virtual ~SelectionEngineBase() = default;
+
+    /// name of the selection
+    const std::string& name() const { return m_name; }
+    /// cut statistics, in registration order
+    const std::vector<CutStats>& stats() const { return m_stats; }
+    /// current evaluation order (indices into stats())
+    const std::vector<std::size_t>& order() const { return m_order; }
+    /// number of times the order was recomputed
+    uint64_t nReorders() const { return m_nReorders; }
+
+    /// expected cycles per rejected object of a cut
+    double score(const CutStats& stats) const;
+
+    /// sort the cuts by increasing cost per rejection
+    void reorder();
+
+    /// to be called once per event (reorders when it is time to)
+    void newEvent();
+
+    /// current order with measured cost and rejection of each cut
+    std::string describeOrder() const;
+
+  };
+
+  /** @class xTRT::SelectionEngine
+   *  @brief Adaptive cut order selection of Ctx objects
+   *
+   *  example:
+   *
+   *      xTRT::SelectionEngine<Foo> engine("Foos",100,1000);
+   *      engine.addCut("pT", [](const Foo& foo) { return foo.pT > 5; });
+   *      engine.addCut("iso",[](const Foo& foo) { return expensiveIso(foo) < 0.1; });
+   *      ...
+   *      bool pass = engine.pass(foo);
+   */
+  template <class Ctx>
+  class SelectionEngine : public SelectionEngineBase {
+
+  public:
+    /// a cut: true if the object passes
+    using Predicate = std::function<bool(const Ctx&)>;
+
+  private:
+    std::vector<Predicate> m_cuts;
+
+  public:
+    /// an engine learning over learnEvents events and reordering every reorderPeriod events after that
+    SelectionEngine(const std::string& name, const uint64_t learnEvents = 100,
+                    const uint64_t reorderPeriod = 1000);
+
+    /// register a cut
+    void addCut(const std::string& name, Predicate pass);
+
+    /// true if the object passes all cuts
+    /**
+     *  The cuts run in the current (changing) order, so the engine
+     *  is not used together with an xTRT::CutFlow.
+     */
+    bool pass(const Ctx& ctx);
+
+  };
+
+}
+
+#include "SelectionEngine.icc"
+
+#endif
@@ -0,0 +1,216 @@
+/** @file  StrawAccumulator.h
+ *  @brief xTRT::StrawAccumulator class header and TRT straw geometry table
+ *  @class xTRT::StrawAccumulator
+ *  @brief Running per straw sums for straw level calibration studies
+ *
+ *  Every TRT readout channel (straw) is given a dense integer id with
+ *  xTRT::StrawGeometry::strawId, using a compile time table of the
+ *  number of straws per straw layer. The accumulator keeps one
+ *  contiguous array per quantity indexed by that id, so adding a hit
+ *  is a couple of array updates and the whole detector takes ~8 MB
+ *  (instead of one histogram or map entry per straw).
+ *
+ *  Next to the hit and HT hit counts, the arrays hold running means
+ *  (ToT, drift time, T0) and the running ToT variance as floats
+ *  rather than double sums: a mean stays of the order of one value,
+ *  so float precision holds for any number of hits, where a float
+ *  sum would lose digits as it grows. The sums are rebuilt from
+ *  them (n*mean, n*(variance+mean^2)).
+ *
+ *  The id layout is: barrel side A (bec = 1), barrel side C (bec =
+ *  -1), end cap side A (bec = 2), end cap side C (bec = -2). In the
+ *  barrel the ids run over phi module, then absolute straw layer,
+ *  then straw number; in the end caps over absolute straw layer,
+ *  then phi module, then straw number.
+ *
+ *  The accumulated sums are written with xTRT::StrawAccumulator::write
+ *  as one TTree entry per straw with at least one hit (xTRT::Algorithm
+ *  does this in finalize, see xTRT::Algorithm::strawAccumulator).
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_StrawAccumulator_h
+#define xTRTFrame_StrawAccumulator_h
+
+// C++
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// xTRTFrame
+#include <xTRTFrame/HitSummary.h>
+#include <xTRTFrame/HitBlock.h>
+#include <xTRTFrame/Helpers.h>
+
+class TTree;
+
+namespace xTRT {
+
+  namespace StrawGeometry {
+
+    /// number of phi modules (barrel and end cap)
+    constexpr int nPhiModules = 32;
+
+    /// number of barrel straw layers (all module types)
+    constexpr int nBarrelAbsStrawLayers = 73;
+    /// number of straws in one phi module for each absolute barrel straw layer
+    constexpr int barrelStrawsPerModule[nBarrelAbsStrawLayers] = {
+      // type 1
+      15, 16, 16, 16, 16, 17, 17, 17, 17, 17, 18, 18, 18, 18, 18, 19, 19, 19, 18,
+      // type 2
+      19, 20, 20, 20, 20, 20, 21, 21, 21, 21, 21, 22, 22, 22, 22, 22, 23, 23, 23, 23,
+      23, 24, 24, 23,
+      // type 3
+      23, 24, 24, 24, 24, 25, 25, 25, 25, 25, 26, 26, 26, 26, 26, 27, 27, 27, 27, 27,
+      28, 28, 28, 28, 28, 29, 29, 29, 29, 28
+    };
+
+    /// number of end cap wheels (6 type A, 8 type B)
+    constexpr int nEndCapWheels = 14;
+    /// number of end cap straw layers (all wheels)
+    constexpr int nEndCapAbsStrawLayers = 160;
+    /// number of straws in one phi module of an end cap straw layer
+    constexpr int endCapStrawsPerModule = 24;
+
+    /// first straw of each absolute barrel straw layer inside a phi module
+    struct BarrelOffsets {
+      int v[nBarrelAbsStrawLayers + 1];
+    };
+    constexpr BarrelOffsets makeBarrelOffsets() {
+      BarrelOffsets o{};
+      for ( int i = 0; i < nBarrelAbsStrawLayers; ++i ) {
+        o.v[i+1] = o.v[i] + barrelStrawsPerModule[i];
+      }
+      return o;
+    }
+    constexpr BarrelOffsets barrelOffsets = makeBarrelOffsets();
+
+    /// number of straws in one barrel phi module
+    constexpr int barrelStrawsPerPhiModule = barrelOffsets.v[nBarrelAbsStrawLayers];
+    /// number of straws on one side of the barrel
+    constexpr int nBarrelStrawsPerSide = nPhiModules * barrelStrawsPerPhiModule;
+    /// number of straws in one end cap straw layer
+    constexpr int endCapStrawsPerLayer = nPhiModules * endCapStrawsPerModule;
+    /// number of straws in one end cap
+    constexpr int nEndCapStrawsPerSide = nEndCapAbsStrawLayers * endCapStrawsPerLayer;
+    /// total number of straws (readout channels)
+    constexpr int nStraws = 2 * nBarrelStrawsPerSide + 2 * nEndCapStrawsPerSide;
+
+    static_assert(barrelStrawsPerPhiModule == 1642, "bad barrel straw table");
+    static_assert(nStraws == 350848, "bad TRT straw count");
+
+    /// dense id of a straw in [0,nStraws), -1 if the identifiers are not a TRT straw
+    /**
+     *  @param bec the barrel/endcap value ("bec" on the drift circle)
+     *  @param layer the layer or wheel ("layer" on the drift circle)
+     *  @param phi_module the phi module ("phi_module" on the drift circle)
+     *  @param strawlayer the straw layer ("strawlayer" on the drift circle)
+     *  @param strawnumber the straw ("strawnumber" on the drift circle)
+     */
+    constexpr int strawId(const int bec, const int layer, const int phi_module,
+                          const int strawlayer, const int strawnumber) {
+      const int absSL = xTRT::absoluteStrawLayer(bec,layer,strawlayer);
+      if ( absSL < 0 || phi_module < 0 || phi_module >= nPhiModules || strawnumber < 0 ) return -1;
+      if ( bec == 1 || bec == -1 ) {
+        if ( strawnumber >= barrelStrawsPerModule[absSL] ) return -1;
+        return ( bec == 1 ? 0 : nBarrelStrawsPerSide ) + phi_module * barrelStrawsPerPhiModule
+          + barrelOffsets.v[absSL] + strawnumber;
+      }
+      if ( strawnumber >= endCapStrawsPerModule ) return -1;
+      return 2 * nBarrelStrawsPerSide + ( bec == 2 ? 0 : nEndCapStrawsPerSide )
+        + absSL * endCapStrawsPerLayer + phi_module * endCapStrawsPerModule + strawnumber;
+    }
+
+    static_assert(strawId(1,0,0,0,0) == 0, "bad straw id layout");
+    static_assert(strawId(-2,13,31,7,23) == nStraws - 1, "bad straw id layout");
+
+  }
+
+  class StrawAccumulator {
+
+  private:
+    std::vector<uint32_t> m_nHits;
+    std::vector<uint32_t> m_nHT;
+    std::vector<float>    m_meanToT;
+    std::vector<float>    m_varToT; ///< population variance
+    std::vector<float>    m_meanDriftTime;
+    std::vector<float>    m_meanT0;
+    std::size_t           m_nRejected{0};
+
+    /// add n values with the given mean and population variance of ToT (and means) to straw id
+    void merge(const int id, const uint32_t n, const uint32_t nHT, const double meanToT,
+               const double varToT, const double meanDriftTime, const double meanT0);
+
+  public:
+    /// allocate (zeroed) sums for all xTRT::StrawGeometry::nStraws straws
+    StrawAccumulator();
+    ~StrawAccumulator() = default;
+
+    /// add a hit to straw id (must be a valid id)
+    void add(const int id, const int HT, const float tot, const float drifttime, const float T0) {
+      const float inv = 1.0f/(++m_nHits[id]);
+      m_nHT[id] += ( HT ? 1 : 0 );
+      // Welford update of the ToT mean and variance
+      const float dtot = tot - m_meanToT[id];
+      m_meanToT[id]       += dtot*inv;
+      m_varToT[id]        += (dtot*(tot - m_meanToT[id]) - m_varToT[id])*inv;
+      m_meanDriftTime[id] += (drifttime - m_meanDriftTime[id])*inv;
+      m_meanT0[id]        += (T0 - m_meanT0[id])*inv;
+    }
+
+    /// add a hit, returns false (and skips it) if it isn't a valid TRT straw
+    bool add(const xTRT::HitSummary& hit);
+    /// add all hits in a block, returns the number of hits added
+    std::size_t add(const xTRT::HitBlock& block);
+
+    /// add the sums stored in a tree made by xTRT::StrawAccumulator::write
+    /**
+     *  Used to merge the accumulators of several jobs (e.g. the
+     *  ranges of a xTRT::Runner --jobs run) straw by straw. Returns
+     *  the number of entries added, entries with a bad id are skipped.
+     *
+     *  @param tree the tree with the accumulated sums
+     */
+    std::size_t add(TTree* tree);
+
+    /// reset all sums to zero
+    void clear();
+
+    /// number of hits on straw id
+    uint32_t nHits(const int id)        const { return m_nHits[id]; }
+    /// number of high threshold (middle bit) hits on straw id
+    uint32_t nHT(const int id)          const { return m_nHT[id]; }
+    /// sum of ToT on straw id
+    double   sumToT(const int id)       const { return double(m_nHits[id])*m_meanToT[id]; }
+    /// sum of ToT squared on straw id
+    double   sumToT2(const int id)      const {
+      return double(m_nHits[id])*(double(m_varToT[id]) + double(m_meanToT[id])*m_meanToT[id]);
+    }
+    /// sum of drift time on straw id
+    double   sumDriftTime(const int id) const { return double(m_nHits[id])*m_meanDriftTime[id]; }
+    /// sum of T0 on straw id
+    double   sumT0(const int id)        const { return double(m_nHits[id])*m_meanT0[id]; }
+
+    /// number of hits rejected because the straw identifiers were bad
+    std::size_t nRejected() const { return m_nRejected; }
+    /// number of straws with at least one hit
+    std::size_t nStrawsHit() const;
+    /// memory used by the sums (bytes)
+    std::size_t memoryBytes() const;
+
+    /// write one entry per straw with at least one hit to the tree
+    /**
+     *  Branches: id, bec, layer, phi_module, strawlayer, strawnumber
+     *  (identifiers decoded from the id), nHits, nHT, sumToT,
+     *  sumToT2, sumDriftTime, sumT0.
+     *
+     *  @param tree the (empty) output tree
+     */
+    void write(TTree* tree) const;
+
+  };
+
+}
+
+#endif
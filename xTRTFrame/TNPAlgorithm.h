@@ -13,6 +13,9 @@
 #define xTRTFrame_TNPAlgorithm_h
 
 #include <xTRTFrame/Algorithm.h>
+#include <xTRTFrame/BitMask.h>
+
+#include <TLorentzVector.h>
 
 namespace xTRT {
 
@@ -51,13 +54,29 @@ namespace xTRT {
     bool m_selectionCalled; //!
     bool m_containersMade;  //!
 
+    const xAOD::ElectronContainer* m_tagElectrons{nullptr};   //!
+    const xAOD::ElectronContainer* m_probeElectrons{nullptr}; //!
+    const xAOD::MuonContainer*     m_goodMuons{nullptr};      //!
+
     std::vector<float>       m_invMassesEl;  //!
     std::vector<float>       m_invMassesMu;  //!
     std::vector<std::size_t> m_probeIndices; //!
     std::vector<std::size_t> m_tagIndices;   //!
     std::vector<std::size_t> m_muonIndices;  //!
-    typedef std::vector<std::size_t>::iterator idx_t;
 
+    // per object pre-qualification (bit i is object i in the raw container)
+    xTRT::BitMask               m_tagCandidates;   //!
+    xTRT::BitMask               m_probeCandidates; //!
+    xTRT::BitMask               m_usedProbes;      //!
+    xTRT::BitMask               m_muonCandidates;  //!
+    xTRT::BitMask               m_muonTrigMatched; //!
+    std::vector<TLorentzVector> m_candP4;          //!
+    std::vector<float>          m_candCharge;      //!
+
+    // cut flows of the single object selections (null unless config says CutFlow)
+    xTRT::CutFlow* m_tagCutFlow{nullptr};     //!
+    xTRT::CutFlow* m_probeCutFlow{nullptr};   //!
+    xTRT::CutFlow* m_muonTNPCutFlow{nullptr}; //!
 
   private:
     EL::StatusCode performZeeSelection();
@@ -66,8 +85,15 @@ namespace xTRT {
     EL::StatusCode makeContainers();
     void           clear();
 
-    bool passZeeTNP(const xAOD::Electron* Tag, const xAOD::Electron* Probe);
-    bool passZmumuTNP(const xAOD::Muon* mu1, const xAOD::Muon* mu2);
+    /// single object tag requirements (everything but the pair cuts)
+    bool passTagSelection(const xAOD::Electron* electron);
+    /// single object probe requirements (everything but the pair cuts)
+    bool passProbeSelection(const xAOD::Electron* electron);
+    /// single object muon requirements (everything but trigger matching and the pair cuts)
+    bool passMuonTNPSelection(const xAOD::Muon* muon);
+    /// pair requirements: opposite sign and invariant mass in the Z window
+    static bool passPair(const TLorentzVector& p1, const float q1,
+                         const TLorentzVector& p2, const float q2, float& invMass);
 
     ////// selection helper functions
     static bool passAuthor(const xAOD::Electron* electron);
@@ -0,0 +1,117 @@
+/** @file  Timing.h
+ *  @brief xTRT::Timing stage timers
+ *
+ *  The framework's own work per event is split into a few stages
+ *  (container retrieval, selections, InDetTrackSelectionTool calls,
+ *  trigger decisions and matching, tag and probe selection, hit
+ *  extraction and the user's execute). A xTRT::Timing::StageTimer
+ *  placed in a scope adds the time spent in that scope to its stage.
+ *
+ *  Timers nest: a stage's self time excludes the time of the timers
+ *  started inside it (an IDTS call inside a selection counts as IDTS
+ *  only), the total time includes it. Counters are kept per thread
+ *  and summed by xTRT::Timing::collect.
+ *
+ *  Timing is off by default (config option Timing); a disabled timer
+ *  only tests one global flag.
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_Timing_h
+#define xTRTFrame_Timing_h
+
+// C++
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace xTRT {
+  namespace Timing {
+
+    /// timed stages
+    enum Stage : std::size_t {
+      Retrieve = 0, ///< container and EventInfo retrieval
+      Selection,    ///< selected containers (config and IDTS cuts)
+      IDTS,         ///< InDetTrackSelectionTool accept calls
+      Trigger,      ///< trigger decisions and matching
+      TNP,          ///< tag and probe selection
+      Hits,         ///< hit extraction (HitSummary, HitBlock)
+      UserExecute,  ///< the derived algorithm's execute
+      NStages
+    };
+
+    /// name of a stage (as used in the table and the JSON file)
+    const char* stageName(const Stage stage);
+
+    /// counters of all stages
+    struct Counters {
+      uint64_t calls[NStages]{};
+      uint64_t totalNs[NStages]{}; ///< including nested stages
+      uint64_t selfNs[NStages]{};  ///< excluding nested stages
+      void add(const Counters& other);
+    };
+
+    namespace detail {
+      extern bool enabled;
+    }
+
+    /// true if timers are counting
+    inline bool enabled() { return detail::enabled; }
+    /// turn the timers on or off (before the event loop)
+    void enable(const bool on);
+
+    /// sum of the counters of all threads
+    Counters collect();
+    /// zero the counters of all threads (at the start of a job, no timer running)
+    void reset();
+
+    /// print the per stage table (times per event for nEvents > 0)
+    void printTable(std::ostream& out, const Counters& counters, const std::size_t nEvents);
+    /// write the counters to a JSON file
+    bool writeJSON(const std::string& fileName, const Counters& counters, const std::size_t nEvents);
+    /// add the counters and number of events of a JSON file written by writeJSON
+    bool readJSON(const std::string& fileName, Counters& counters, std::size_t& nEvents);
+
+    /** @class xTRT::Timing::StageTimer
+     *  @brief Adds the lifetime of the object to a stage
+     *
+     *  example:
+     *
+     *      {
+     *        xTRT::Timing::StageTimer timer(xTRT::Timing::Hits);
+     *        ... // timed
+     *      }
+     */
+    class StageTimer {
+
+    private:
+      Stage       m_stage;
+      bool        m_active;
+      StageTimer* m_parent{nullptr};
+      uint64_t    m_start{0};
+      uint64_t    m_childNs{0};
+
+      void start();
+
+    public:
+      explicit StageTimer(const Stage stage) : m_stage(stage), m_active(enabled()) {
+        if ( m_active ) start();
+      }
+      ~StageTimer() {
+        if ( m_active ) stop();
+      }
+
+      StageTimer(const StageTimer&) = delete;
+      StageTimer& operator=(const StageTimer&) = delete;
+
+      /// stop before the end of the scope (timers must stop in reverse start order)
+      void stop();
+
+    };
+
+  }
+}
+
+#endif
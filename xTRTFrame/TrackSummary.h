@@ -0,0 +1,65 @@
+/** @file  TrackSummary.h
+ *  @brief xTRT::TrackSummary class header
+ *  @class xTRT::TrackSummary
+ *  @brief Class for storing track summary information
+ *
+ *  This is a compact (POD) record of the hit counts and kinematics
+ *  used by the track, electron, muon and tag and probe selections.
+ *  xTRT::Algorithm fills one per InDetTrackParticle per event in a
+ *  single pass over the aux store, see
+ *  xTRT::Algorithm::trackSummary.
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_TrackSummary_h
+#define xTRTFrame_TrackSummary_h
+
+#include <cstdint>
+
+namespace xTRT {
+
+  /** \addtogroup ParticlePropGetters Particle Property Getters
+   *  @{
+   */
+
+  struct TrackSummary {
+
+    uint8_t nTRTHits;
+    uint8_t nTRTOutliers;
+    uint8_t nTRTHTHits;
+    uint8_t nTRTHTOutliers;
+    uint8_t nPixelHits;
+    uint8_t nPixelHoles;
+    uint8_t nPixelShared;
+    uint8_t nIBLHits;
+    uint8_t nSCTHits;
+    uint8_t nSCTHoles;
+    uint8_t nSCTShared;
+
+    float pT;
+    float eta;
+    float p;
+    float theta;
+
+    /// number of TRT hits (prec+tube and outliers)
+    int nTRT()           const { return (int)nTRTHits + (int)nTRTOutliers;   }
+    /// number of TRT prec+tube hits (non outlier)
+    int nTRT_PrecTube()  const { return (int)nTRTHits;                       }
+    /// number of TRT outliers
+    int nTRT_Outlier()   const { return (int)nTRTOutliers;                   }
+    /// number of pixel hits
+    int nPixel()         const { return (int)nPixelHits;                     }
+    /// number of silicon hits (Pixel + SCT)
+    int nSilicon()       const { return (int)nPixelHits + (int)nSCTHits;     }
+    /// number of silicon holes (Pixel + SCT)
+    int nSiliconHoles()  const { return (int)nPixelHoles + (int)nSCTHoles;   }
+    /// number of silicon shared hits (Pixel + SCT)
+    int nSiliconShared() const { return (int)nPixelShared + (int)nSCTShared; }
+
+  };
+
+  /** @}*/
+}
+
+#endif
@@ -0,0 +1,116 @@
+/** @file  WorkQueue.h
+ *  @brief xTRT::WorkQueue class header (local parallel run scheduler)
+ *  @class xTRT::WorkQueue
+ *  @brief Queue of event ranges shared by forked worker processes
+ *
+ *  The input files are cut into event ranges (xTRT::WorkRange, a file
+ *  plus first entry and number of entries), largest first. The queue
+ *  lives in anonymous shared memory created before the workers are
+ *  forked: a worker takes the next range with one atomic increment,
+ *  so workers which finish early keep picking up ranges until the
+ *  queue is empty instead of idling while a static share of a slow
+ *  worker is still running.
+ *
+ *  Every worker records its busy time, number of ranges and events
+ *  and the time it ran out of work in its own slot, which the parent
+ *  reads after all workers exited (see xTRT::WorkQueue::printSummary).
+ *
+ *  @author Douglas Davis < ddavis@cern.ch >
+ */
+
+#ifndef xTRTFrame_WorkQueue_h
+#define xTRTFrame_WorkQueue_h
+
+// C++
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SH {
+  class SampleHandler;
+}
+
+namespace xTRT {
+
+  /// part of a sample's input: entries [first, first+nEntries) of a file
+  struct WorkRange {
+    std::string sample;
+    std::string file;
+    std::size_t fileIndex; ///< position of the file in the input (all samples, in order)
+    long long   first;
+    long long   nEntries; ///< -1: the whole file (entries unknown)
+  };
+
+  /// cut the files of all samples into ranges of at most rangeSize entries
+  /**
+   *  Files are opened to count their entries (in treeName); a file
+   *  which can't be read is one whole-file range. A rangeSize of 0
+   *  keeps whole files. Ranges are sorted largest first; sort by
+   *  (fileIndex, first) to get back the input order.
+   *
+   *  @param sh the samples
+   *  @param treeName the event tree name
+   *  @param rangeSize maximum number of entries per range (0: no splitting)
+   */
+  std::vector<xTRT::WorkRange> makeWorkRanges(const SH::SampleHandler& sh, const std::string& treeName,
+                                              const long long rangeSize);
+
+  class WorkQueue {
+
+  public:
+    /// per worker bookkeeping (written by the worker only)
+    struct WorkerStats {
+      double   busySeconds;   ///< time spent processing ranges
+      double   finishSeconds; ///< time (since queue creation) the worker ran out of ranges
+      uint64_t nRanges;       ///< number of ranges processed
+      uint64_t nEvents;       ///< number of events in those ranges (known sizes only)
+    };
+
+  private:
+    // the worker slots follow this header in the shared mapping
+    struct Shared {
+      std::atomic<uint64_t> next;
+      double                start;
+    };
+
+    Shared*      m_shared;
+    WorkerStats* m_workers;
+    std::size_t  m_bytes;
+    std::size_t  m_nRanges;
+    int          m_nWorkers;
+
+  public:
+    /// create the shared queue (must be done before forking)
+    WorkQueue(const std::size_t nRanges, const int nWorkers);
+    ~WorkQueue();
+
+    WorkQueue(const WorkQueue&) = delete;
+    WorkQueue& operator=(const WorkQueue&) = delete;
+
+    /// index of the next range to process, -1 if none are left
+    long long next() {
+      const uint64_t i = m_shared->next.fetch_add(1,std::memory_order_relaxed);
+      return ( i < m_nRanges ) ? static_cast<long long>(i) : -1;
+    }
+
+    /// seconds since the queue was created (same clock in all processes)
+    double elapsed() const;
+
+    /// record a processed range for a worker
+    void recordRange(const int worker, const double busySeconds, const long long nEvents);
+    /// record that a worker found the queue empty
+    void recordFinished(const int worker);
+
+    /// bookkeeping of one worker
+    const WorkerStats& stats(const int worker) const { return m_workers[worker]; }
+
+    /// print per worker busy time, utilization and the tail latency
+    void printSummary() const;
+
+  };
+
+}
+
+#endif